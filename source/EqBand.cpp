@@ -0,0 +1,324 @@
+#include "EqBand.h"
+#include "EqDynamics.h"
+
+//==============================================================================
+template <typename SampleType>
+void EqBand<SampleType>::prepare(const juce::dsp::ProcessSpec &spec, SectionState<Lanes> *stateStorage, size_t stride)
+{
+    states = stateStorage;
+    numGroups = LaneInterleaver<SampleType>::getNumGroups(spec.numChannels);
+    stateStride = stride;
+
+    setSampleRate(spec.sampleRate);
+}
+
+template <typename SampleType>
+void EqBand<SampleType>::setSampleRate(double newSampleRate) noexcept
+{
+    sampleRate = newSampleRate;
+
+    frequency.reset(sampleRate, smoothingTimeSeconds);
+    q.reset(sampleRate, smoothingTimeSeconds);
+    gain.reset(sampleRate, smoothingTimeSeconds);
+    mix.reset(sampleRate, bypassFadeMilliseconds * 0.001);
+
+    designCurrent();
+    reset();
+}
+
+template <typename SampleType>
+void EqBand<SampleType>::reset() noexcept
+{
+    for (size_t group = 0; group < numGroups; ++group)
+        for (size_t s = 0; s < (size_t) maxSections; ++s)
+            states[group * stateStride + s] = {};
+}
+
+template <typename SampleType>
+void EqBand<SampleType>::setSmoothingInterval(int numSamples) noexcept
+{
+    smoothingInterval = juce::jmax(0, numSamples);
+
+    if (smoothingInterval == 0 && (frequency.isSmoothing() || gain.isSmoothing() || q.isSmoothing()))
+        setParameters(frequency.getTargetValue(), gain.getTargetValue(), q.getTargetValue(), true);
+}
+
+template <typename SampleType>
+void EqBand<SampleType>::setTopology(Topology newTopology, bool jump) noexcept
+{
+    requestChange(changePending ? pendingType : type, changePending ? pendingRouting : routing, newTopology, jump);
+}
+
+template <typename SampleType>
+void EqBand<SampleType>::setType(FilterType newType, bool jump) noexcept
+{
+    requestChange(newType, changePending ? pendingRouting : routing, changePending ? pendingTopology : topology, jump);
+}
+
+template <typename SampleType>
+void EqBand<SampleType>::setRouting(ChannelRouting newRouting, bool jump) noexcept
+{
+    requestChange(changePending ? pendingType : type, newRouting, changePending ? pendingTopology : topology, jump);
+}
+
+template <typename SampleType>
+void EqBand<SampleType>::requestChange(FilterType newType, ChannelRouting newRouting, Topology newTopology, bool jump) noexcept
+{
+    auto isCurrent = newType == type && newRouting == routing && newTopology == topology;
+
+    // Une bande contournée n'a rien à effacer
+    if (jump || ! isActive() || bypassFadeMilliseconds <= 0.0f)
+    {
+        changePending = false;
+        mix.setTargetValue(enabled ? 1.0f : 0.0f);
+
+        if (! isCurrent)
+        {
+            applyChange(newType, newRouting, newTopology);
+            warmStartPending = true;
+        }
+
+        return;
+    }
+
+    if (changePending ? (newType == pendingType && newRouting == pendingRouting && newTopology == pendingTopology) : isCurrent)
+        return;
+
+    // Retour au réglage actuel avant la fin du fondu : la bande revient simplement
+    if (isCurrent)
+    {
+        changePending = false;
+        mix.setTargetValue(enabled ? 1.0f : 0.0f);
+        return;
+    }
+
+    pendingType = newType;
+    pendingRouting = newRouting;
+    pendingTopology = newTopology;
+    changePending = true;
+    mix.setTargetValue(0.0f);
+}
+
+template <typename SampleType>
+void EqBand<SampleType>::applyChange(FilterType newType, ChannelRouting newRouting, Topology newTopology) noexcept
+{
+    type = newType;
+    routing = newRouting;
+    topology = newTopology;
+    numSections = EqFilterDesign::getNumSections(type);
+    designCurrent();
+    reset();
+}
+
+template <typename SampleType>
+void EqBand<SampleType>::setParameters(float newFrequency, float newGainDecibels, float newQ, bool jump) noexcept
+{
+    if (jump || smoothingInterval == 0)
+    {
+        frequency.setCurrentAndTargetValue(newFrequency);
+        gain.setCurrentAndTargetValue(newGainDecibels);
+        q.setCurrentAndTargetValue(newQ);
+        designCurrent();
+        return;
+    }
+
+    frequency.setTargetValue(newFrequency);
+    gain.setTargetValue(newGainDecibels);
+    q.setTargetValue(newQ);
+}
+
+template <typename SampleType>
+void EqBand<SampleType>::setBypassFadeTime(float milliseconds) noexcept
+{
+    if (milliseconds == bypassFadeMilliseconds)
+        return;
+
+    // BYPASS_FADE est automatisable : un fondu en cours repart de sa valeur courante vers la même cible, à la
+    // nouvelle durée, au lieu de sauter à la cible (reset() termine la rampe)
+    auto current = mix.getCurrentValue();
+    auto target = mix.getTargetValue();
+
+    bypassFadeMilliseconds = juce::jmax(0.0f, milliseconds);
+    mix.reset(sampleRate, bypassFadeMilliseconds * 0.001);
+    mix.setCurrentAndTargetValue(current);
+    mix.setTargetValue(target);
+}
+
+template <typename SampleType>
+void EqBand<SampleType>::setEnabled(bool shouldBeEnabled, bool jump) noexcept
+{
+    if (shouldBeEnabled && ! isActive())
+        warmStartPending = true;
+
+    enabled = shouldBeEnabled;
+
+    if (jump)
+    {
+        // Plus de fondu à attendre pour un changement de type ou de routage en cours
+        if (changePending)
+        {
+            changePending = false;
+            applyChange(pendingType, pendingRouting, pendingTopology);
+        }
+
+        mix.setCurrentAndTargetValue(shouldBeEnabled ? 1.0f : 0.0f);
+    }
+    // Pendant le fondu de sortie d'un changement de type, la valeur demandée est reprise à la fin du fondu
+    else if (! changePending)
+    {
+        mix.setTargetValue(shouldBeEnabled ? 1.0f : 0.0f);
+    }
+}
+
+template <typename SampleType>
+bool EqBand<SampleType>::isSmoothing() const noexcept
+{
+    return frequency.isSmoothing() || gain.isSmoothing() || q.isSmoothing() || mix.isSmoothing() || changePending
+        || detector != nullptr || designedGain != gain.getCurrentValue();
+}
+
+template <typename SampleType>
+void EqBand<SampleType>::setDynamics(const EqDetector *detectorToUse, size_t keyStep) noexcept
+{
+    // Sans son détecteur, la bande partirait vers la profondeur maximale pendant qu'elle s'efface
+    auto fadingOut = mix.getTargetValue() <= 0.0f && mix.getCurrentValue() > 0.0f;
+    auto wasHolding = holdingDynamicGain;
+    holdingDynamicGain = detectorToUse == nullptr && fadingOut && (detector != nullptr || holdingDynamicGain);
+
+    detector = detectorToUse;
+    detectorPosition = 0;
+    detectorStep = juce::jmax((size_t) 1, keyStep);
+
+    // Fondu terminé : la bande contournée reprend le gain réglé. Réactivée pendant le fondu, elle y revient
+    // avec la rampe habituelle de beginSubBlock()
+    if (wasHolding && ! holdingDynamicGain && mix.getCurrentValue() <= 0.0f)
+        designCurrent();
+}
+
+template <typename SampleType>
+void EqBand<SampleType>::design(BiquadCoefficients<SampleType> *c) const noexcept
+{
+    EqFilterDesign::design<SampleType>(type, sampleRate, frequency.getCurrentValue(), q.getCurrentValue(), designedGain, c);
+}
+
+template <typename SampleType>
+void EqBand<SampleType>::design(SvfCoefficients<SampleType> *c) const noexcept
+{
+    EqFilterDesign::design<SampleType>(type, sampleRate, frequency.getCurrentValue(), q.getCurrentValue(), designedGain, c);
+}
+
+// Seuls les coefficients de la structure active sont tenus à jour
+template <typename SampleType>
+void EqBand<SampleType>::designCurrent() noexcept
+{
+    // En mode dynamique, le gain du détecteur reste en place jusqu'au prochain sous-bloc
+    if (detector == nullptr && ! holdingDynamicGain)
+        designedGain = gain.getCurrentValue();
+
+    if (topology == Topology::svf)
+        design(svfCoefficients.data());
+    else
+        design(biquadCoefficients.data());
+}
+
+//==============================================================================
+template <typename SampleType>
+bool EqBand<SampleType>::beginSubBlock(size_t numSamples, Section *sections) noexcept
+{
+    // Fin du fondu de sortie d'un changement de type : la bande revient avec son nouveau type, son nouveau routage
+    // et sa nouvelle structure
+    if (changePending && mix.getCurrentValue() <= 0.0f)
+    {
+        holdingDynamicGain = false;
+        changePending = false;
+        applyChange(pendingType, pendingRouting, pendingTopology);
+        warmStartPending = true;
+        mix.setTargetValue(enabled ? 1.0f : 0.0f);
+    }
+
+    auto parametersSmoothing = (frequency.isSmoothing() || gain.isSmoothing() || q.isSmoothing()) && numSamples > 0;
+
+    if (parametersSmoothing)
+    {
+        // Avance les rampes jusqu'à la fin du sous-bloc : les coefficients seront interpolés jusque-là
+        frequency.skip((int) numSamples);
+        gain.skip((int) numSamples);
+        q.skip((int) numSamples);
+    }
+
+    // Gain visé à la fin du sous-bloc : le gain réglé, celui du détecteur au dernier échantillon du sous-bloc,
+    // ou le dernier gain du détecteur pendant le fondu de sortie
+    auto targetGain = holdingDynamicGain ? designedGain : gain.getCurrentValue();
+
+    if (detector != nullptr && numSamples > 0)
+    {
+        detectorPosition += numSamples;
+        targetGain = detector->getGainDecibels((detectorPosition - 1) / detectorStep, targetGain);
+    }
+
+    ramping = numSamples > 0 && (parametersSmoothing || targetGain != designedGain);
+
+    if (ramping)
+    {
+        designedGain = targetGain;
+
+        if (topology == Topology::svf)
+            design(svfTarget.data());
+        else
+            design(biquadTarget.data());
+    }
+
+    auto scale = ramping ? (SampleType) 1 / (SampleType) numSamples : (SampleType) 0;
+
+    // Le fondu est une rampe linéaire : avancer de numSamples d'un coup donne exactement la fin du sous-bloc
+    auto mixStart = mix.getCurrentValue();
+    auto mixEnd = numSamples > 0 ? mix.skip((int) numSamples) : mixStart;
+    auto mixStep = numSamples > 0 ? (SampleType) (mixEnd - mixStart) / (SampleType) numSamples : (SampleType) 0;
+
+    for (int s = 0; s < numSections; ++s)
+    {
+        auto &section = sections[s];
+        section.topology = topology;
+        section.routing = routing;
+        section.states = states + s;
+        section.stateStride = stateStride;
+        section.warmStart = warmStartPending;
+        section.mix = (SampleType) mixStart;
+        section.mixStep = mixStep;
+
+        if (topology == Topology::svf)
+        {
+            section.svf = svfCoefficients[(size_t) s];
+            section.svfStep = ramping ? svfCoefficients[(size_t) s].getStepTowards(svfTarget[(size_t) s], scale)
+                                      : SvfCoefficients<SampleType>{ 0, 0, 0, 0, 0, 0 };
+        }
+        else
+        {
+            section.biquad = biquadCoefficients[(size_t) s];
+            section.biquadStep = ramping ? biquadCoefficients[(size_t) s].getStepTowards(biquadTarget[(size_t) s], scale)
+                                         : BiquadCoefficients<SampleType>{ 0, 0, 0, 0, 0 };
+        }
+    }
+
+    warmStartPending = false;
+
+    return ramping || mixStart < 1.0f || mixEnd != mixStart;
+}
+
+template <typename SampleType>
+void EqBand<SampleType>::endSubBlock() noexcept
+{
+    if (! ramping)
+        return;
+
+    // Les coefficients de fin de rampe sont repris exactement, sans l'erreur accumulée par l'interpolation
+    if (topology == Topology::svf)
+        svfCoefficients = svfTarget;
+    else
+        biquadCoefficients = biquadTarget;
+
+    ramping = false;
+}
+
+template class EqBand<float>;
+template class EqBand<double>;
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "EqCascade.h"
+
+class EqDetector;
+
+//==============================================================================
+/**
+    Une bande de l'EQ : filtre multicanal (cloche, plateau, passe-haut, passe-bas ou
+    coupe-bande, voir FilterType) avec lissage des paramètres.
+
+    La bande fournit ses coefficients et son état à EqCascade, qui traite toutes les
+    bandes en une passe sur des blocs entrelacés par LaneInterleaver : chaque
+    échantillon est un registre SIMD qui porte plusieurs canaux, traités en parallèle
+    avec un seul jeu de coefficients et un état par voie.
+
+    Une bande est faite de une à EqFilterDesign::maxSectionsPerFilter cellules du
+    second ordre (les pentes raides sont des cascades), toutes traitées dans la même
+    passe que les autres bandes. Chaque cellule peut être réalisée par un biquad en
+    forme directe II transposée (comme juce::dsp::IIR::Filter) ou par une cellule à
+    variables d'état TPT, qui reste stable sous modulation rapide et précise en float
+    aux basses fréquences. Les deux ont la même réponse en fréquence.
+
+    La bande peut ne traiter qu'un canal de chaque paire gauche / droite, ou leur milieu
+    ou leur côté (ChannelRouting) : c'est EqCascade qui l'applique, dans la même passe, avec les
+    mêmes coefficients pour toutes les voies.
+
+    Un changement de type ou de routage passe par le signal direct : la bande s'efface avec le fondu
+    de contournement, change de type une fois complètement contournée, puis revient
+    avec le fondu inverse et un état initialisé au régime permanent. Rien n'est alloué :
+    les coefficients du type le plus raide ont toujours leur place.
+
+    Quand le lissage est actif, la fréquence, le gain et le Q suivent une rampe
+    (logarithmique pour la fréquence et le Q, linéaire en dB pour le gain). Les
+    coefficients ne sont recalculés que tous les N échantillons (le "sous-bloc"),
+    et interpolés linéairement entre ces points. Le coût est donc borné à un calcul
+    de coefficients par sous-bloc et par bande pendant une rampe, et à zéro sinon.
+
+    En mode dynamique (voir EqDynamics), le gain est lu dans le détecteur de la bande à
+    la fin de chaque sous-bloc et prend la place du gain réglé dans le calcul des
+    coefficients : même chemin que le lissage, un calcul par sous-bloc et des
+    incréments linéaires entre deux, quel que soit le rythme des variations.
+
+    L'interpolation linéaire reste stable pour les deux structures : le domaine de
+    stabilité d'un biquad dans le plan (a1, a2) est un triangle, donc convexe, et la
+    cellule TPT est stable pour tout jeu de coefficients issu de g > 0 et k > 0.
+
+    SampleType (float ou double) est la précision des coefficients et de l'état ;
+    les paramètres et leurs rampes restent en float.
+*/
+template <typename SampleType>
+class EqBand
+{
+public:
+    using Topology = SectionTopology;
+
+    using Lanes = typename LaneInterleaver<SampleType>::Lanes;
+
+    using Section = CascadeSection<SampleType>;
+
+    static constexpr int maxSections = EqFilterDesign::maxSectionsPerFilter;
+
+    EqBand() = default;
+
+    // Durée des rampes de paramètres
+    static constexpr double smoothingTimeSeconds = 0.05;
+
+    /*  L'état de la bande n'est pas alloué par la bande : pour chaque groupe de canaux g,
+        stateStorage[g * stateStride + k] est l'état de la cellule k (maxSections cellules
+        consécutives ; EqEngine range les états de toutes ses bandes dans un seul tableau,
+        groupe par groupe). Il doit rester valide jusqu'au prochain prepare().
+    */
+    void prepare(const juce::dsp::ProcessSpec &spec, SectionState<Lanes> *stateStorage, size_t stateStride);
+
+    // Thread audio, sans allocation : nouvelle fréquence d'échantillonnage (suréchantillonnage), rampes
+    // et état remis à zéro ; les coefficients sont recalculés pour les valeurs courantes
+    void setSampleRate(double newSampleRate) noexcept;
+
+    void reset() noexcept;
+
+    // Nombre d'échantillons entre deux calculs de coefficients pendant une rampe ; 0 désactive le lissage
+    // (les coefficients sont alors remplacés d'un bloc à l'autre)
+    void setSmoothingInterval(int numSamples) noexcept;
+
+    // Les variables d'état des deux structures n'ont pas le même sens : même fondu qu'un changement de type,
+    // puis la nouvelle structure part du régime permanent ; jump = true change immédiatement
+    void setTopology(Topology newTopology, bool jump) noexcept;
+
+    Topology getTopology() const noexcept { return topology; }
+
+    // Nouveau type de bande, avec un fondu par le signal direct ; jump = true change immédiatement
+    void setType(FilterType newType, bool jump) noexcept;
+
+    FilterType getType() const noexcept { return type; }
+
+    // Canaux traités (stéréo, gauche, droite, milieu, côté), avec le même fondu qu'un changement de type
+    void setRouting(ChannelRouting newRouting, bool jump) noexcept;
+
+    ChannelRouting getRouting() const noexcept { return routing; }
+
+    // Nombre de cellules que beginSubBlock() remplit
+    int getNumSections() const noexcept { return numSections; }
+
+    // Nouvelles valeurs cibles ; jump = true saute directement à la cible (activation de la bande, nouvelle fréquence d'échantillonnage)
+    void setParameters(float frequency, float gainDecibels, float q, bool jump) noexcept;
+
+    // Durée du fondu d'activation / désactivation de la bande
+    void setBypassFadeTime(float milliseconds) noexcept;
+
+    /*  Active ou désactive la bande avec un fondu entre le signal filtré et le signal direct.
+        Une fois le fondu de désactivation terminé, isActive() renvoie false et la bande ne coûte
+        plus rien. A la réactivation, l'état est initialisé au régime permanent du premier
+        échantillon d'entrée plutôt que repris à zéro ou là où il s'était arrêté.
+        jump = true applique le changement sans fondu (préparation).
+    */
+    void setEnabled(bool shouldBeEnabled, bool jump) noexcept;
+
+    // false quand la bande est complètement contournée : elle peut alors être sautée
+    bool isActive() const noexcept { return mix.getCurrentValue() > 0.0f || mix.getTargetValue() > 0.0f || changePending; }
+
+    bool isSmoothing() const noexcept;
+
+    /*  Thread audio, avant chaque bloc : détecteur dont le gain remplace celui de la bande pendant ce
+        bloc (nullptr : bande statique, le gain revient au réglage avec une rampe). keyStep est le
+        nombre d'échantillons de la bande par échantillon du détecteur (facteur de suréchantillonnage).
+        Un détecteur retiré pendant le fondu de sortie de la bande (coupure, changement de type) laisse
+        son dernier gain en place jusqu'à la fin du fondu.
+    */
+    void setDynamics(const EqDetector *detectorToUse, size_t keyStep) noexcept;
+
+    // Remplit les getNumSections() premiers éléments de sections pour les numSamples échantillons suivants
+    // (en avançant les rampes s'il y en a) ; renvoie true si les coefficients ou le mélange doivent être
+    // interpolés pendant ce sous-bloc
+    bool beginSubBlock(size_t numSamples, Section *sections) noexcept;
+
+    void endSubBlock() noexcept;
+
+private:
+    void design(BiquadCoefficients<SampleType> *c) const noexcept;
+
+    void design(SvfCoefficients<SampleType> *c) const noexcept;
+
+    void designCurrent() noexcept;
+
+    // Type, routage et structure demandés ensemble : fondu de sortie, ou changement immédiat si jump
+    void requestChange(FilterType newType, ChannelRouting newRouting, Topology newTopology, bool jump) noexcept;
+
+    // Change de type, de routage et de structure sans fondu : nouveaux coefficients, état remis à zéro
+    void applyChange(FilterType newType, ChannelRouting newRouting, Topology newTopology) noexcept;
+
+    // maxSections états par groupe de canaux entrelacés, tous les stateStride éléments
+    SectionState<Lanes> *states = nullptr;
+    size_t numGroups = 0;
+    size_t stateStride = 1;
+
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> frequency{1000.0f}, q{1.0f};
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> gain{0.0f};
+
+    // Proportion de signal filtré : 1 = bande active, 0 = contournée
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> mix{1.0f};
+    float bypassFadeMilliseconds = 10.0f;
+    bool warmStartPending = false;
+    bool enabled = true;
+
+    // Type, routage et structure demandés pendant que la bande s'efface, appliqués quand mix atteint 0
+    FilterType type = FilterType::bell, pendingType = FilterType::bell;
+    ChannelRouting routing = ChannelRouting::stereo, pendingRouting = ChannelRouting::stereo;
+    Topology topology = Topology::biquad, pendingTopology = Topology::biquad;
+    bool changePending = false;
+    int numSections = 1;
+
+    std::array<BiquadCoefficients<SampleType>, maxSections> biquadCoefficients, biquadTarget;
+    std::array<SvfCoefficients<SampleType>, maxSections> svfCoefficients, svfTarget;
+    bool ramping = false;
+    double sampleRate = 44100.0;
+
+    // Gain des coefficients courants : celui de la rampe, ou celui du détecteur en mode dynamique
+    float designedGain = 0.0f;
+    const EqDetector *detector = nullptr;
+
+    // Détecteur retiré pendant un fondu de sortie : designedGain garde son dernier gain jusqu'à la fin du fondu
+    bool holdingDynamicGain = false;
+    size_t detectorPosition = 0;
+    size_t detectorStep = 1;
+    int smoothingInterval = 0;
+
+    //==============================================================================
+    JUCE_LEAK_DETECTOR(EqBand)
+};
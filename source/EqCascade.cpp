@@ -0,0 +1,223 @@
+#include "EqCascade.h"
+#include "EqBand.h"
+
+//==============================================================================
+template <typename SampleType>
+void EqCascade<SampleType>::prepare(size_t numChannels, const std::vector<bool> &stereoPairs)
+{
+    auto numLanes = LaneInterleaver<SampleType>::numLanes;
+    groupPairs.assign(LaneInterleaver<SampleType>::getNumGroups(numChannels), {});
+
+    for (size_t group = 0; group < groupPairs.size(); ++group)
+    {
+        auto &pairs = groupPairs[group];
+        pairs.mask = Lanes::expand((SampleType) 1);
+
+        // Les voies sans canal gardent 1 : une disposition stéréo reste sur le chemin le plus court
+        for (size_t lane = 0; lane < numLanes; ++lane)
+        {
+            auto pair = (group * numLanes + lane) / 2;
+
+            if (pair * 2 < numChannels && (pair >= stereoPairs.size() || ! stereoPairs[pair]))
+            {
+                pairs.mask.set(lane, (SampleType) 0);
+                pairs.all = false;
+            }
+        }
+    }
+}
+
+template <typename SampleType>
+void EqCascade<SampleType>::process(const juce::dsp::AudioBlock<Lanes> &block, EqBand<SampleType> *const *bands, size_t numBands,
+                        int smoothingInterval) noexcept
+{
+    jassert(groupPairs.size() >= block.getNumChannels());
+
+    auto numSamples = block.getNumSamples();
+    size_t start = 0;
+
+    while (start < numSamples)
+    {
+        // Toutes les bandes partagent les mêmes frontières de sous-bloc ; hors rampe, le reste du bloc d'un coup
+        auto anySmoothing = false;
+
+        for (size_t b = 0; b < numBands; ++b)
+            anySmoothing = anySmoothing || bands[b]->isSmoothing();
+
+        auto length = anySmoothing && smoothingInterval > 0 ? juce::jmin((size_t) smoothingInterval, numSamples - start)
+                                                            : numSamples - start;
+
+        // Les cellules de toutes les bandes, à la suite : une passe raide compte pour plusieurs cellules
+        auto ramping = false;
+        size_t numSections = 0;
+
+        for (size_t b = 0; b < numBands; ++b)
+        {
+            jassert(numSections + (size_t) bands[b]->getNumSections() <= maxSections);
+
+            ramping = bands[b]->beginSubBlock(length, sections.data() + numSections) || ramping;
+            numSections += (size_t) bands[b]->getNumSections();
+        }
+
+        processSubBlock(block, start, length, sections.data(), numSections, ramping, groupPairs.data());
+
+        for (size_t b = 0; b < numBands; ++b)
+            bands[b]->endSubBlock();
+
+        start += length;
+    }
+}
+
+template <typename SampleType>
+void EqCascade<SampleType>::processSubBlock(const juce::dsp::AudioBlock<Lanes> &block, size_t startSample, size_t numSamples,
+                                const Section *sections, size_t numSections, bool ramping, const GroupPairs *groupPairs) noexcept
+{
+    for (size_t group = 0; group < block.getNumChannels(); ++group)
+    {
+        auto *samples = block.getChannelPointer(group) + startSample;
+        auto &pairs = groupPairs[group];
+
+        for (size_t first = 0; first < numSections; first += maxFusedSections)
+        {
+            auto count = juce::jmin(maxFusedSections, numSections - first);
+
+            if (ramping)
+                dispatch<true>(samples, numSamples, sections + first, count, group, pairs, std::make_index_sequence<maxFusedSections>());
+            else
+                dispatch<false>(samples, numSamples, sections + first, count, group, pairs, std::make_index_sequence<maxFusedSections>());
+        }
+    }
+}
+
+// Choisit l'instance du noyau correspondant au nombre de cellules actives
+template <typename SampleType>
+template <bool Ramping, size_t... Counts>
+void EqCascade<SampleType>::dispatch(Lanes *samples, size_t numSamples, const Section *sections, size_t numSections,
+                         size_t group, const GroupPairs &pairs, std::index_sequence<Counts...>) noexcept
+{
+    ((numSections == Counts + 1 ? processGroup<Counts + 1, Ramping>(samples, numSamples, sections, group, pairs) : void()), ...);
+}
+
+template <typename SampleType>
+template <size_t NumSections, bool Ramping>
+void EqCascade<SampleType>::processGroup(Lanes *samples, size_t numSamples, const Section *sections, size_t group,
+                                         const GroupPairs &pairs) noexcept
+{
+    std::array<SectionTopology, NumSections> topology;
+    std::array<ChannelRouting, NumSections> routing;
+    std::array<Lanes, NumSections> routingMask;
+    std::array<BiquadCoefficients<SampleType>, NumSections> biquad;
+    std::array<SvfCoefficients<SampleType>, NumSections> svf;
+    std::array<SectionState<Lanes>, NumSections> state;
+    std::array<SampleType, NumSections> mix;
+    auto anyWarmStart = false;
+
+    for (size_t s = 0; s < NumSections; ++s)
+    {
+        topology[s] = sections[s].topology;
+        routing[s] = sections[s].routing;
+        routingMask[s] = pairs.all ? getRoutingMask<SampleType>(routing[s]) : getRoutingMask<SampleType>(routing[s], pairs.mask);
+        biquad[s] = sections[s].biquad;
+        svf[s] = sections[s].svf;
+        state[s] = sections[s].states[group * sections[s].stateStride];
+        mix[s] = sections[s].mix;
+        anyWarmStart = anyWarmStart || sections[s].warmStart;
+    }
+
+    // Entrée d'une cellule : le signal, ou le milieu / le côté de chaque paire de canaux (dans les deux voies de la paire) ;
+    // hors des vraies paires, le signal lui-même
+    auto getSectionInput = [&](size_t s, Lanes x) noexcept
+    {
+        if (routing[s] != ChannelRouting::mid && routing[s] != ChannelRouting::side)
+            return x;
+
+        auto swapped = swapChannelPairs(x);
+        auto input = (routing[s] == ChannelRouting::mid ? x + swapped : x - swapped) * (SampleType) 0.5;
+
+        return pairs.all ? input : x + (input - x) * pairs.mask;
+    };
+
+    // Hors rampe, toutes les cellules reçues sont entièrement actives (mix == 1) :
+    // le mélange avec le signal direct n'est calculé que dans le noyau Ramping
+    auto processSection = [&](size_t s, Lanes x) noexcept
+    {
+        auto input = getSectionInput(s, x);
+        Lanes y;
+
+        if (topology[s] == SectionTopology::svf)
+        {
+            if constexpr (Ramping)
+                svf[s].advance(sections[s].svfStep);
+
+            y = SvfSection<SampleType>::processSample(svf[s], state[s], input);
+        }
+        else
+        {
+            if constexpr (Ramping)
+                biquad[s].advance(sections[s].biquadStep);
+
+            y = BiquadSection<SampleType>::processSample(biquad[s], state[s], input);
+        }
+
+        if constexpr (Ramping)
+            mix[s] += sections[s].mixStep;
+
+        if (routing[s] == ChannelRouting::stereo)
+        {
+            if constexpr (Ramping)
+                y = x + (y - x) * mix[s];
+
+            return y;
+        }
+
+        // Seule la contribution de la cellule est ajoutée, dans les voies concernées : pour le milieu
+        // et le côté, c'est aussi le décodage (G = M + S, D = M - S), sans autre passe
+        auto gain = routingMask[s];
+
+        if constexpr (Ramping)
+            gain = gain * mix[s];
+
+        return x + (y - input) * gain;
+    };
+
+    size_t start = 0;
+
+    if (anyWarmStart && numSamples > 0)
+    {
+        auto x = samples[0];
+
+        for (size_t s = 0; s < NumSections; ++s)
+        {
+            if (sections[s].warmStart)
+            {
+                auto input = getSectionInput(s, x);
+
+                if (topology[s] == SectionTopology::svf)
+                    SvfSection<SampleType>::prime(svf[s], state[s], input);
+                else
+                    BiquadSection<SampleType>::prime(biquad[s], state[s], input);
+            }
+
+            x = processSection(s, x);
+        }
+
+        samples[0] = x;
+        start = 1;
+    }
+
+    for (size_t i = start; i < numSamples; ++i)
+    {
+        auto x = samples[i];
+
+        for (size_t s = 0; s < NumSections; ++s)
+            x = processSection(s, x);
+
+        samples[i] = x;
+    }
+
+    for (size_t s = 0; s < NumSections; ++s)
+        sections[s].states[group * sections[s].stateStride] = state[s];
+}
+
+template class EqCascade<float>;
+template class EqCascade<double>;
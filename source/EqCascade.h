@@ -0,0 +1,98 @@
+#pragma once
+
+#include "EqSections.h"
+#include "LaneInterleaver.h"
+
+template <typename SampleType>
+class EqBand;
+
+//==============================================================================
+/*  Ce qu'il faut au noyau fusionné pour faire avancer une cellule du second ordre
+    pendant un sous-bloc (une bande en compte une ou plusieurs) :
+    coefficients de départ, pas d'interpolation par échantillon (nul hors rampe),
+    proportion de signal filtré (fondu de contournement) et état de chaque groupe de canaux.
+*/
+template <typename SampleType>
+struct CascadeSection
+{
+    using Lanes = typename LaneInterleaver<SampleType>::Lanes;
+
+    SectionTopology topology = SectionTopology::biquad;
+    ChannelRouting routing = ChannelRouting::stereo;
+    BiquadCoefficients<SampleType> biquad, biquadStep;
+    SvfCoefficients<SampleType> svf, svfStep;
+    SampleType mix = 1;
+    SampleType mixStep = 0;
+
+    // Initialise l'état au régime permanent du premier échantillon du sous-bloc (réactivation de la bande)
+    bool warmStart = false;
+
+    // État du groupe g : states[g * stateStride]
+    SectionState<Lanes> *states = nullptr;
+    size_t stateStride = 1;
+};
+
+//==============================================================================
+/**
+    Traitement en une seule passe de plusieurs bandes en cascade.
+
+    Pour chaque échantillon, toutes les cellules sont évaluées l'une après l'autre
+    avec leur état gardé dans des variables locales (donc dans les registres) :
+    le bloc n'est lu et écrit qu'une fois, quel que soit le nombre de bandes.
+    Le routage des bandes (voir ChannelRouting) est appliqué dans la même boucle :
+    passage en milieu / côté par un échange de voies dans le registre, et seule la
+    contribution de la cellule est ajoutée aux canaux concernés.
+    Le nombre de cellules est un paramètre de template du noyau, pour que les
+    boucles sur les cellules soient déroulées ; au-delà de maxFusedSections, la
+    cascade est traitée par paquets.
+
+    SampleType (float ou double) fixe la précision des coefficients et de l'état.
+*/
+template <typename SampleType>
+class EqCascade
+{
+public:
+    using Lanes = typename LaneInterleaver<SampleType>::Lanes;
+    using Section = CascadeSection<SampleType>;
+
+    static constexpr size_t maxFusedSections = 8;
+
+    // 32 bandes de 4 cellules (passe-haut ou passe-bas à 48 dB/octave)
+    static constexpr size_t maxSections = 128;
+
+    /*  Thread de messages : stereoPairs[k] est vrai si les canaux 2k et 2k + 1 forment une vraie paire
+        gauche / droite. Les routages gauche, droite, milieu et côté ne s'appliquent qu'à ces paires ;
+        les autres canaux restent en stéréo.
+    */
+    void prepare(size_t numChannels, const std::vector<bool> &stereoPairs);
+
+    // Traite block en place avec les bandes données, dans l'ordre ; les rampes avancent par sous-blocs
+    // de smoothingInterval échantillons
+    void process(const juce::dsp::AudioBlock<Lanes> &block, EqBand<SampleType> *const *bands, size_t numBands,
+                        int smoothingInterval) noexcept;
+
+private:
+    // Voies d'un groupe : 1 pour celles d'une vraie paire (ou sans canal), 0 pour les autres ; all si toutes valent 1
+    struct GroupPairs
+    {
+        Lanes mask;
+        bool all = true;
+    };
+
+    // pairs : un élément par groupe de canaux de block
+    static void processSubBlock(const juce::dsp::AudioBlock<Lanes> &block, size_t startSample, size_t numSamples,
+                                const Section *sections, size_t numSections, bool ramping, const GroupPairs *pairs) noexcept;
+
+    std::vector<GroupPairs> groupPairs;
+
+    // Réutilisé d'un bloc à l'autre, pour ne pas le réinitialiser à chaque appel
+    std::array<Section, maxSections> sections;
+
+    template <size_t NumSections, bool Ramping>
+    static void processGroup(Lanes *samples, size_t numSamples, const Section *sections, size_t group,
+                             const GroupPairs &pairs) noexcept;
+
+    template <bool Ramping, size_t... Counts>
+    static void dispatch(Lanes *samples, size_t numSamples, const Section *sections, size_t numSections,
+                         size_t group, const GroupPairs &pairs, std::index_sequence<Counts...>) noexcept;
+};
@@ -0,0 +1,171 @@
+#include "EqDynamics.h"
+
+namespace
+{
+    // Plancher de l'enveloppe en dB, bien sous le seuil le plus bas
+    constexpr float floorDecibels = -120.0f;
+}
+
+//==============================================================================
+EqDetector::EqDetector()
+{
+    ballistics.setLevelCalculationType(juce::dsp::BallisticsFilterLevelCalculationType::RMS);
+}
+
+void EqDetector::prepare(double newSampleRate, int maximumBlockSize)
+{
+    sampleRate = newSampleRate;
+    ballistics.prepare({ sampleRate, (juce::uint32) maximumBlockSize, 1 });
+    envelope.assign((size_t) maximumBlockSize, 0.0f);
+    numSamples = 0;
+
+    // Force le calcul du passe-bande au prochain setParameters()
+    frequency = 0.0f;
+    reset();
+}
+
+void EqDetector::reset() noexcept
+{
+    s1 = s2 = 0.0;
+    ballistics.reset();
+}
+
+void EqDetector::setParameters(float newFrequency, float newQ, float thresholdDecibels, float ratio,
+                               float attackMilliseconds, float releaseMilliseconds) noexcept
+{
+    if (newFrequency != frequency || newQ != q)
+    {
+        frequency = newFrequency;
+        q = newQ;
+
+        auto raw = juce::dsp::IIR::ArrayCoefficients<double>::makeBandPass(
+            sampleRate, (double) EqFilterDesign::clampFrequency(sampleRate, frequency), (double) q);
+        auto a0Inv = 1.0 / raw[3];
+        bandPass = { raw[0] * a0Inv, raw[1] * a0Inv, raw[2] * a0Inv, raw[4] * a0Inv, raw[5] * a0Inv };
+    }
+
+    // setAttackTime() et setReleaseTime() calculent une exponentielle : seulement au changement
+    if (attackMilliseconds != attack)
+        ballistics.setAttackTime(attack = attackMilliseconds);
+
+    if (releaseMilliseconds != release)
+        ballistics.setReleaseTime(release = releaseMilliseconds);
+
+    threshold = thresholdDecibels;
+    slope = 1.0f - 1.0f / juce::jmax(1.0f, ratio);
+}
+
+void EqDetector::process(const float *key, size_t numSamplesToProcess) noexcept
+{
+    jassert(numSamplesToProcess <= envelope.size());
+    numSamples = juce::jmin(numSamplesToProcess, envelope.size());
+
+    auto &c = bandPass;
+
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+        auto x = (double) key[i];
+        auto y = c.b0 * x + s1;
+        s1 = c.b1 * x - c.a1 * y + s2;
+        s2 = c.b2 * x - c.a2 * y;
+
+        envelope[i] = ballistics.processSample(0, (float) y);
+    }
+
+    ballistics.snapToZero();
+}
+
+float EqDetector::getGainDecibels(size_t index, float rangeDecibels) const noexcept
+{
+    if (numSamples == 0)
+        return 0.0f;
+
+    auto level = juce::Decibels::gainToDecibels(envelope[juce::jmin(index, numSamples - 1)], floorDecibels);
+    auto amount = juce::jmax(0.0f, level - threshold) * slope;
+
+    return rangeDecibels < 0.0f ? -juce::jmin(amount, -rangeDecibels) : juce::jmin(amount, rangeDecibels);
+}
+
+//==============================================================================
+void EqDynamics::prepare(double sampleRate, int maximumBlockSize)
+{
+    for (auto &detector : detectors)
+        detector.prepare(sampleRate, maximumBlockSize);
+
+    inputKey.assign((size_t) maximumBlockSize, 0.0f);
+    sidechainKey.assign((size_t) maximumBlockSize, 0.0f);
+    active.fill(false);
+    numSamples = 0;
+}
+
+void EqDynamics::reset() noexcept
+{
+    for (auto &detector : detectors)
+        detector.reset();
+}
+
+template <typename SampleType>
+void EqDynamics::mixDown(const juce::dsp::AudioBlock<SampleType> &block, std::vector<float> &key) noexcept
+{
+    auto count = juce::jmin(block.getNumSamples(), key.size());
+    auto gain = (float) (1.0 / (double) block.getNumChannels());
+    auto *first = block.getChannelPointer(0);
+
+    for (size_t i = 0; i < count; ++i)
+        key[i] = (float) first[i] * gain;
+
+    for (size_t channel = 1; channel < block.getNumChannels(); ++channel)
+    {
+        auto *input = block.getChannelPointer(channel);
+
+        for (size_t i = 0; i < count; ++i)
+            key[i] += (float) input[i] * gain;
+    }
+}
+
+template <typename SampleType>
+void EqDynamics::process(const juce::dsp::AudioBlock<SampleType> &input, const juce::dsp::AudioBlock<SampleType> &sidechain) noexcept
+{
+    numSamples = juce::jmin(input.getNumSamples(), inputKey.size());
+
+    auto hasSidechain = sidechain.getNumChannels() > 0 && sidechain.getNumSamples() >= numSamples;
+    auto inputMixed = false, sidechainMixed = false;
+
+    for (size_t i = 0; i < detectors.size(); ++i)
+    {
+        auto &band = eqParameters.getBand((int) i);
+        auto type = (FilterType) juce::jlimit(0, (int) EqFilterDesign::lastFilterType, juce::roundToInt(band.type->load()));
+        auto isDynamic = band.dynamic->load() >= 0.5f && band.on->load() >= 0.5f && EqFilterDesign::hasGain(type);
+
+        // Une bande qui redevient dynamique repart d'une enveloppe vide
+        if (! isDynamic)
+        {
+            if (active[i])
+                detectors[i].reset();
+
+            active[i] = false;
+            continue;
+        }
+
+        active[i] = true;
+
+        // Le mélange mono de chaque entrée n'est calculé que si une bande en a besoin
+        auto useSidechain = hasSidechain && band.sidechain->load() >= 0.5f;
+        auto &key = useSidechain ? sidechainKey : inputKey;
+        auto &mixed = useSidechain ? sidechainMixed : inputMixed;
+
+        if (! mixed)
+        {
+            mixDown(useSidechain ? sidechain : input, key);
+            mixed = true;
+        }
+
+        auto &detector = detectors[i];
+        detector.setParameters(band.freq->load(), band.q->load(), band.threshold->load(), band.ratio->load(),
+                               band.attack->load(), band.release->load());
+        detector.process(key.data(), numSamples);
+    }
+}
+
+template void EqDynamics::process(const juce::dsp::AudioBlock<float> &, const juce::dsp::AudioBlock<float> &) noexcept;
+template void EqDynamics::process(const juce::dsp::AudioBlock<double> &, const juce::dsp::AudioBlock<double> &) noexcept;
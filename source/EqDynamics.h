@@ -0,0 +1,122 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "EqFilterDesign.h"
+#include "EqParameters.h"
+
+//==============================================================================
+/**
+    Détecteur d'une bande dynamique : le signal de commande est filtré par un passe-bande
+    à la fréquence et au Q de la bande, puis suivi par un juce::dsp::BallisticsFilter en
+    mode RMS (temps d'attaque et de relâchement de la bande).
+
+    L'enveloppe de tout le bloc est gardée ; le calcul du gain (seuil, taux) n'est fait
+    que pour les échantillons que la bande lit réellement, à la fin de chaque sous-bloc.
+*/
+class EqDetector
+{
+public:
+    EqDetector();
+
+    // Thread de messages
+    void prepare(double sampleRate, int maximumBlockSize);
+
+    void reset() noexcept;
+
+    // Thread audio : le passe-bande n'est recalculé que si la fréquence ou le Q ont changé
+    void setParameters(float frequency, float q, float thresholdDecibels, float ratio,
+                       float attackMilliseconds, float releaseMilliseconds) noexcept;
+
+    // Thread audio : enveloppe des numSamples échantillons de key (mono)
+    void process(const float *key, size_t numSamples) noexcept;
+
+    size_t getNumSamples() const noexcept { return numSamples; }
+
+    /*  Gain de la bande à l'échantillon index du dernier bloc, en dB : au-dessus du seuil, le
+        dépassement réduit par le taux, borné par rangeDecibels (le gain de la bande) et de
+        même signe ; 0 sous le seuil.
+    */
+    float getGainDecibels(size_t index, float rangeDecibels) const noexcept;
+
+private:
+    double sampleRate = 44100.0;
+
+    // Passe-bande de gain unité au centre, en double comme les autres calculs de coefficients
+    BiquadCoefficients<double> bandPass;
+    double s1 = 0.0, s2 = 0.0;
+    float frequency = 0.0f, q = 0.0f;
+
+    juce::dsp::BallisticsFilter<float> ballistics;
+    float attack = -1.0f, release = -1.0f;
+
+    float threshold = 0.0f;
+
+    // 1 - 1 / taux : part du dépassement convertie en gain
+    float slope = 0.0f;
+
+    std::vector<float> envelope;
+    size_t numSamples = 0;
+
+    //==============================================================================
+    JUCE_LEAK_DETECTOR(EqDetector)
+};
+
+//==============================================================================
+/**
+    Mode dynamique des bandes : le gain d'une bande suit le niveau du signal autour de sa
+    fréquence, au-delà d'un seuil. Le gain réglé devient la profondeur maximale : une
+    cloche à -6 dB ne coupe que quand le signal dépasse le seuil, et jamais plus de 6 dB.
+
+    Les détecteurs tournent à la fréquence de l'hôte, sur le signal avant l'EQ (entrée
+    principale ou, pour les bandes qui le demandent, bus de sidechain ramené en mono),
+    avant la cascade. Chaque bande dynamique lit ensuite son gain à la fin de chaque
+    sous-bloc (EqBand::setDynamics()) : ses coefficients sont recalculés une fois par
+    sous-bloc et interpolés entre deux, comme pendant le lissage des paramètres, jamais à
+    chaque échantillon.
+
+    Seuls les types dont la réponse dépend du gain (cloches et plateaux) peuvent être
+    dynamiques ; en phase linéaire, les bandes restent statiques.
+*/
+class EqDynamics
+{
+public:
+    // Intervalle de recalcul des coefficients des bandes dynamiques quand le lissage est désactivé
+    static constexpr int defaultUpdateInterval = 32;
+
+    explicit EqDynamics(EqParameters &parametersToUse) : eqParameters(parametersToUse) {}
+
+    // Thread de messages, à la fréquence de l'hôte
+    void prepare(double sampleRate, int maximumBlockSize);
+
+    void reset() noexcept;
+
+    // Thread audio : met à jour les détecteurs des bandes dynamiques avec le signal avant l'EQ et
+    // le sidechain (sans canal : les bandes en sidechain utilisent l'entrée principale)
+    template <typename SampleType>
+    void process(const juce::dsp::AudioBlock<SampleType> &input, const juce::dsp::AudioBlock<SampleType> &sidechain) noexcept;
+
+    // Détecteur de la bande pour le dernier bloc, nullptr si elle est statique
+    const EqDetector *getDetector(int bandIndex) const noexcept
+    {
+        return active[(size_t) bandIndex] ? &detectors[(size_t) bandIndex] : nullptr;
+    }
+
+    // Longueur du dernier bloc traité, à la fréquence de l'hôte
+    size_t getNumSamples() const noexcept { return numSamples; }
+
+private:
+    // Mélange mono de block dans key
+    template <typename SampleType>
+    static void mixDown(const juce::dsp::AudioBlock<SampleType> &block, std::vector<float> &key) noexcept;
+
+    EqParameters &eqParameters;
+
+    std::array<EqDetector, (size_t) EqParameters::numBands> detectors;
+    std::array<bool, (size_t) EqParameters::numBands> active {};
+
+    std::vector<float> inputKey, sidechainKey;
+    size_t numSamples = 0;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EqDynamics)
+};
@@ -0,0 +1,156 @@
+#include "EqEngine.h"
+
+//==============================================================================
+template <typename SampleType, int NumBands>
+void EqEngine<SampleType, NumBands>::prepare(const juce::dsp::ProcessSpec &spec, const juce::AudioChannelSet &layout)
+{
+    interleaver.prepare(spec);
+
+    std::vector<bool> stereoPairs(spec.numChannels / 2);
+
+    for (size_t pair = 0; pair < stereoPairs.size(); ++pair)
+        stereoPairs[pair] = isStereoPair(layout, (int) pair);
+
+    cascade.prepare(spec.numChannels, stereoPairs);
+    hasChannelPairs = std::find(stereoPairs.begin(), stereoPairs.end(), true) != stereoPairs.end();
+    states.assign(LaneInterleaver<SampleType>::getNumGroups(spec.numChannels) * (size_t) NumBands * sectionsPerBand, {});
+
+    for (size_t i = 0; i < bands.size(); ++i)
+        bands[i].prepare(spec, states.data() + i * sectionsPerBand, (size_t) NumBands * sectionsPerBand);
+
+    // Force le recalcul des coefficients pour la nouvelle fréquence d'échantillonnage
+    filtersNeedUpdate = true;
+    updateFilters();
+}
+
+template <typename SampleType, int NumBands>
+bool EqEngine<SampleType, NumBands>::isStereoPair(const juce::AudioChannelSet &layout, int pairIndex)
+{
+    using Type = juce::AudioChannelSet::ChannelType;
+
+    static constexpr std::pair<Type, Type> pairs[] = {
+        { Type::left, Type::right },
+        { Type::leftSurround, Type::rightSurround },
+        { Type::leftCentre, Type::rightCentre },
+        { Type::leftSurroundSide, Type::rightSurroundSide },
+        { Type::leftSurroundRear, Type::rightSurroundRear },
+        { Type::wideLeft, Type::wideRight },
+        { Type::topFrontLeft, Type::topFrontRight },
+        { Type::topSideLeft, Type::topSideRight },
+        { Type::topRearLeft, Type::topRearRight }
+    };
+
+    if (pairIndex * 2 + 1 >= layout.size())
+        return false;
+
+    auto left = layout.getTypeOfChannel(pairIndex * 2);
+    auto right = layout.getTypeOfChannel(pairIndex * 2 + 1);
+
+    return std::find(std::begin(pairs), std::end(pairs), std::make_pair(left, right)) != std::end(pairs);
+}
+
+template <typename SampleType, int NumBands>
+void EqEngine<SampleType, NumBands>::setSampleRate(double newSampleRate) noexcept
+{
+    for (auto &band : bands)
+        band.setSampleRate(newSampleRate);
+
+    filtersNeedUpdate = true;
+}
+
+template <typename SampleType, int NumBands>
+template <typename IOType>
+void EqEngine<SampleType, NumBands>::process(const juce::dsp::AudioBlock<IOType> &block, const EqDynamics *dynamics) noexcept
+{
+    updateFilters();
+
+    auto smoothingInterval = eqParameters.getSmoothingInterval();
+    auto anyDynamic = false;
+    auto keyStep = dynamics != nullptr && dynamics->getNumSamples() > 0 ? block.getNumSamples() / dynamics->getNumSamples() : (size_t) 1;
+
+    for (size_t i = 0; i < bands.size(); ++i)
+    {
+        auto *detector = dynamics != nullptr ? dynamics->getDetector((int) i) : nullptr;
+        bands[i].setDynamics(detector, keyStep);
+        anyDynamic = anyDynamic || detector != nullptr;
+    }
+
+    // Sans lissage, les bandes dynamiques ont quand même besoin de sous-blocs pour suivre leur détecteur
+    if (anyDynamic && smoothingInterval == 0)
+        smoothingInterval = EqDynamics::defaultUpdateInterval;
+
+    std::array<EqBand<SampleType> *, (size_t) NumBands> activeBands;
+    size_t numActiveBands = 0;
+
+    // Une bande coupée ne coûte plus rien une fois son fondu terminé
+    for (auto &band : bands)
+        if (band.isActive())
+            activeBands[numActiveBands++] = &band;
+
+    if (numActiveBands == 0)
+        return;
+
+    // Un seul entrelacement et une seule passe pour toutes les bandes : les canaux sont traités en parallèle
+    // dans les voies SIMD, et les bandes l'une après l'autre pour chaque échantillon
+    auto lanes = interleaver.interleave(juce::dsp::AudioBlock<const IOType>(block));
+
+    cascade.process(lanes, activeBands.data(), numActiveBands, smoothingInterval);
+
+    interleaver.deinterleave(block);
+}
+
+// Mise à jour des filtres EQ en fonction des paramètres
+// Appelée depuis le thread audio : aucune allocation, les coefficients sont calculés en place
+template <typename SampleType, int NumBands>
+void EqEngine<SampleType, NumBands>::updateFilters() noexcept
+{
+    auto smoothingInterval = eqParameters.getSmoothingInterval();
+    auto bypassFadeTime = eqParameters.getBypassFadeTime();
+
+    for (size_t i = 0; i < bands.size(); ++i)
+    {
+        bands[i].setSmoothingInterval(smoothingInterval);
+        bands[i].setBypassFadeTime(bypassFadeTime);
+        updateBand(bands[i], bandSettings[i], eqParameters.getBand((int) i));
+    }
+
+    filtersNeedUpdate = false;
+}
+
+template <typename SampleType, int NumBands>
+void EqEngine<SampleType, NumBands>::updateBand(EqBand<SampleType> &eqBand, BandSettings &appliedSettings, EqParameters::Band &band) noexcept
+{
+    // Rien n'a bougé depuis le dernier bloc : ni lecture des paramètres, ni calcul
+    auto generation = band.generation.load(std::memory_order_acquire);
+
+    if (! filtersNeedUpdate && generation == appliedSettings.generation)
+        return;
+
+    BandSettings newSettings;
+    newSettings.freq = band.freq->load();
+    newSettings.gain = band.gain->load();
+    newSettings.q = band.q->load();
+    newSettings.on = band.on->load() >= 0.5f;
+    newSettings.topology = juce::roundToInt(band.topology->load());
+    newSettings.type = juce::jlimit(0, (int) EqFilterDesign::lastFilterType, juce::roundToInt(band.type->load()));
+    newSettings.routing = hasChannelPairs ? juce::jlimit(0, (int) ChannelRouting::side, juce::roundToInt(band.routing->load())) : 0;
+    newSettings.generation = generation;
+
+    eqBand.setTopology(newSettings.topology == 1 ? EqBand<SampleType>::Topology::svf : EqBand<SampleType>::Topology::biquad,
+                       filtersNeedUpdate);
+    eqBand.setType((FilterType) newSettings.type, filtersNeedUpdate);
+    eqBand.setRouting((ChannelRouting) newSettings.routing, filtersNeedUpdate);
+
+    // Pas de rampe depuis des valeurs périmées quand la bande était complètement contournée
+    eqBand.setParameters(newSettings.freq, newSettings.gain, newSettings.q, filtersNeedUpdate || ! eqBand.isActive());
+    eqBand.setEnabled(newSettings.on, filtersNeedUpdate);
+
+    appliedSettings = newSettings;
+}
+
+template class EqEngine<float, EqParameters::numBands>;
+template class EqEngine<double, EqParameters::numBands>;
+
+template void EqEngine<float, EqParameters::numBands>::process(const juce::dsp::AudioBlock<float> &, const EqDynamics *) noexcept;
+template void EqEngine<double, EqParameters::numBands>::process(const juce::dsp::AudioBlock<float> &, const EqDynamics *) noexcept;
+template void EqEngine<double, EqParameters::numBands>::process(const juce::dsp::AudioBlock<double> &, const EqDynamics *) noexcept;
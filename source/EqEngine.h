@@ -0,0 +1,90 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "EqBand.h"
+#include "EqDynamics.h"
+#include "EqParameters.h"
+
+//==============================================================================
+/**
+    Le traitement complet de l'EQ pour une précision donnée : les bandes, leur
+    cascade fusionnée et l'entrelacement des canaux dans les voies SIMD.
+
+    SampleType est la précision des coefficients et de l'état des filtres. Le bloc
+    traité peut être d'un autre type (bloc float avec un état en double) : la
+    conversion se fait à l'entrelacement, qui a lieu de toute façon.
+
+    NumBands est fixé à la compilation : les bandes sont des membres (pas d'allocation
+    ni d'indirection par bande, pas d'appel virtuel), et leurs états sont rangés dans
+    un seul tableau, groupe de canaux par groupe de canaux, pour que le noyau fusionné
+    lise les états de toutes les bandes d'un groupe d'un seul tenant. Le coût croît
+    linéairement avec le nombre de bandes.
+
+    Tout est alloué dans prepare() ; process() peut être appelée depuis le thread audio.
+*/
+template <typename SampleType, int NumBands>
+class EqEngine
+{
+public:
+    static_assert(NumBands >= 1 && NumBands <= EqParameters::numBands, "EqParameters must provide every band of the engine");
+
+    using Lanes = typename LaneInterleaver<SampleType>::Lanes;
+
+    explicit EqEngine(EqParameters &parametersToUse) : eqParameters(parametersToUse) {}
+
+    // layout : disposition des spec.numChannels canaux, qui décide des paires où le routage des bandes s'applique
+    void prepare(const juce::dsp::ProcessSpec &spec, const juce::AudioChannelSet &layout);
+
+    // Vrai si les canaux 2k et 2k + 1 de layout forment une paire gauche / droite (avant, surround, côté, arrière, large, haut)
+    static bool isStereoPair(const juce::AudioChannelSet &layout, int pairIndex);
+
+    // Thread audio, sans allocation : change la fréquence d'échantillonnage du traitement (suréchantillonnage)
+    // et remet l'état à zéro ; maximumBlockSize, donné à prepare(), doit couvrir les blocs à la nouvelle fréquence
+    void setSampleRate(double newSampleRate) noexcept;
+
+    /*  Applique les derniers paramètres puis traite block en place. dynamics (optionnel) fournit le
+        gain des bandes dynamiques, déjà calculé pour ce bloc à la fréquence de l'hôte : block peut
+        être suréchantillonné, chaque échantillon du détecteur couvre alors plusieurs échantillons.
+    */
+    template <typename IOType>
+    void process(const juce::dsp::AudioBlock<IOType> &block, const EqDynamics *dynamics = nullptr) noexcept;
+
+private:
+    // Derniers paramètres appliqués à une bande, avec la génération EqParameters correspondante :
+    // les coefficients ne sont recalculés que si la génération a changé
+    struct BandSettings
+    {
+        float freq = 0.0f;
+        float gain = 0.0f;
+        float q = 0.0f;
+        bool on = false;
+        int topology = 0;
+        int type = 0;
+        int routing = 0;
+        juce::uint32 generation = 0;
+    };
+
+    void updateFilters() noexcept;
+
+    void updateBand(EqBand<SampleType> &eqBand, BandSettings &appliedSettings, EqParameters::Band &band) noexcept;
+
+    EqParameters &eqParameters;
+
+    LaneInterleaver<SampleType> interleaver;
+    EqCascade<SampleType> cascade;
+    std::array<EqBand<SampleType>, (size_t) NumBands> bands;
+    std::array<BandSettings, (size_t) NumBands> bandSettings;
+
+    // États de toutes les cellules : celui de la cellule k de la bande b pour le groupe g est
+    // states[(g * NumBands + b) * sectionsPerBand + k]
+    static constexpr size_t sectionsPerBand = (size_t) EqBand<SampleType>::maxSections;
+
+    std::vector<SectionState<Lanes>> states;
+    bool filtersNeedUpdate = true;
+
+    // Sans vraie paire de canaux, toutes les bandes sont en stéréo
+    bool hasChannelPairs = true;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EqEngine)
+};
@@ -0,0 +1,376 @@
+#include "EqFilterDesign.h"
+
+namespace
+{
+    // Forme de réponse d'une cellule du second ordre
+    enum class SectionShape
+    {
+        bell,
+        lowShelf,
+        highShelf,
+        highPass,
+        lowPass,
+        notch,
+        matchedBell
+    };
+
+    SectionShape getSectionShape(FilterType type) noexcept
+    {
+        switch (type)
+        {
+            case FilterType::lowShelf:    return SectionShape::lowShelf;
+            case FilterType::highShelf:   return SectionShape::highShelf;
+            case FilterType::highPass12:
+            case FilterType::highPass24:
+            case FilterType::highPass48:  return SectionShape::highPass;
+            case FilterType::lowPass12:
+            case FilterType::lowPass24:
+            case FilterType::lowPass48:   return SectionShape::lowPass;
+            case FilterType::notch:       return SectionShape::notch;
+            case FilterType::bellMatched: return SectionShape::matchedBell;
+            case FilterType::bell:        break;
+        }
+
+        return SectionShape::bell;
+    }
+
+    /*  Q de la cellule index d'un Butterworth de numSections cellules, 1 / (2 cos ((2k + 1) pi / 4n)),
+        par ordre croissant ; la dernière prend en plus la résonance de la bande (q / 0,707).
+        Pour une seule cellule, cela donne exactement q.
+    */
+    double getSectionQ(int numSections, int index, float q) noexcept
+    {
+        auto sectionQ = 1.0 / (2.0 * std::cos(juce::MathConstants<double>::pi * (2 * index + 1) / (4.0 * numSections)));
+
+        return index == numSections - 1 ? sectionQ * (double) q * juce::MathConstants<double>::sqrt2 : sectionQ;
+    }
+
+    /*  Cloche "matched" de M. Vicanek ("Matched Second Order Digital Filters", 2016), pour la cloche
+        analogique (s² + s A / Q + 1) / (s² + s / (A Q) + 1). Les pôles sont ceux de l'invariance
+        impulsionnelle ; les zéros sont choisis pour que le module au carré égale celui de la cloche
+        analogique au continu et au centre, avec une pente nulle au centre. Le module au carré d'un
+        biquad s'écrit B0 phi0 + B1 phi1 + B2 4 phi0 phi1 (phi1 = sin²(w / 2), phi0 = 1 - phi1) :
+        trois équations linéaires en B0, B1, B2, puis factorisation en b0, b1, b2 à phase minimale.
+        Tout est en double : B2 se déduit d'une différence qui perd de la précision en basse fréquence.
+    */
+    BiquadCoefficients<double> makeMatchedPeak(double sampleRate, double frequency, double q, double gainDecibels) noexcept
+    {
+        auto A = std::pow(10.0, gainDecibels / 40.0);
+        auto centreGainSquared = juce::square(A * A);
+        auto w0 = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+
+        // Pôles de la cloche analogique, amortissement 1 / (2 A Q)
+        auto zeta = 1.0 / (2.0 * q * A);
+        auto decay = std::exp(-zeta * w0);
+
+        BiquadCoefficients<double> c;
+        c.a1 = zeta <= 1.0 ? -2.0 * decay * std::cos(std::sqrt(1.0 - zeta * zeta) * w0)
+                           : -2.0 * decay * std::cosh(std::sqrt(zeta * zeta - 1.0) * w0);
+        c.a2 = decay * decay;
+
+        // Module au carré du dénominateur dans la même base, et sa dérivée en phi1 au centre
+        auto A0 = juce::square(1.0 + c.a1 + c.a2);
+        auto A1 = juce::square(1.0 - c.a1 + c.a2);
+        auto A2 = -4.0 * c.a2;
+
+        auto phi1 = juce::square(std::sin(w0 / 2.0));
+        auto phi0 = 1.0 - phi1;
+
+        auto R1 = (A0 * phi0 + A1 * phi1 + 4.0 * A2 * phi0 * phi1) * centreGainSquared;
+        auto R2 = (A1 - A0 + 4.0 * (phi0 - phi1) * A2) * centreGainSquared;
+
+        auto B0 = A0;
+        auto B2 = (R1 - R2 * phi1 - B0) / (4.0 * phi1 * phi1);
+        auto B1 = R2 + B0 + 4.0 * (phi1 - phi0) * B2;
+
+        auto rootB0 = std::sqrt(B0);
+        auto rootB1 = std::sqrt(juce::jmax(0.0, B1));
+        auto W = 0.5 * (rootB0 + rootB1);
+
+        c.b0 = 0.5 * (W + std::sqrt(juce::jmax(0.0, W * W + B2)));
+        c.b1 = 0.5 * (rootB0 - rootB1);
+        c.b2 = -B2 / (4.0 * c.b0);
+        return c;
+    }
+
+    /*  Cellule TPT de même réponse qu'un biquad stable : le dénominateur de la cellule est
+        (1 + g k + g²) + 2 (g² - 1) z^-1 + (1 - g k + g²) z^-2, ce qui donne g et k à partir de a1, a2 ;
+        m0, m1, m2 viennent du numérateur évalué à Nyquist, au continu, et de b0 - b2.
+    */
+    SvfCoefficients<double> makeSvfFromBiquad(const BiquadCoefficients<double> &c) noexcept
+    {
+        auto dcSum = 1.0 + c.a1 + c.a2;
+        auto nyquistSum = 1.0 - c.a1 + c.a2;
+
+        auto g = std::sqrt(dcSum / nyquistSum);
+        auto k = 2.0 * (1.0 - c.a2) / (nyquistSum * g);
+
+        auto m0 = (c.b0 - c.b1 + c.b2) / nyquistSum;
+        auto m2 = (c.b0 + c.b1 + c.b2) / dcSum - m0;
+        auto m1 = (2.0 * (c.b0 - c.b2) / nyquistSum - m0 * g * k) / g;
+
+        auto a1 = 1.0 / (1.0 + g * (g + k));
+        auto a2 = g * a1;
+        return { a1, a2, g * a2, m0, m1, m2 };
+    }
+
+    template <typename NumericType>
+    BiquadCoefficients<NumericType> makeBiquadSection(SectionShape shape, double sampleRate, float frequency, double q,
+                                                      float gainDecibels) noexcept
+    {
+        using Design = juce::dsp::IIR::ArrayCoefficients<NumericType>;
+
+        if (shape == SectionShape::matchedBell)
+        {
+            auto m = makeMatchedPeak(sampleRate, (double) EqFilterDesign::clampFrequency(sampleRate, frequency), q, (double) gainDecibels);
+            return { (NumericType) m.b0, (NumericType) m.b1, (NumericType) m.b2, (NumericType) m.a1, (NumericType) m.a2 };
+        }
+
+        auto f = (NumericType) EqFilterDesign::clampFrequency(sampleRate, frequency);
+        auto Q = (NumericType) q;
+        auto gain = juce::Decibels::decibelsToGain((NumericType) gainDecibels);
+
+        // raw = { b0, b1, b2, a0, a1, a2 }
+        std::array<NumericType, 6> raw;
+
+        switch (shape)
+        {
+            case SectionShape::lowShelf:  raw = Design::makeLowShelf(sampleRate, f, Q, gain); break;
+            case SectionShape::highShelf: raw = Design::makeHighShelf(sampleRate, f, Q, gain); break;
+            case SectionShape::highPass:  raw = Design::makeHighPass(sampleRate, f, Q); break;
+            case SectionShape::lowPass:   raw = Design::makeLowPass(sampleRate, f, Q); break;
+            case SectionShape::notch:     raw = Design::makeNotch(sampleRate, f, Q); break;
+            case SectionShape::matchedBell:
+            case SectionShape::bell:
+            default:                      raw = Design::makePeakFilter(sampleRate, f, Q, gain); break;
+        }
+
+        auto a0Inv = (NumericType) 1 / raw[3];
+
+        BiquadCoefficients<NumericType> c;
+        c.b0 = raw[0] * a0Inv;
+        c.b1 = raw[1] * a0Inv;
+        c.b2 = raw[2] * a0Inv;
+        c.a1 = raw[4] * a0Inv;
+        c.a2 = raw[5] * a0Inv;
+        return c;
+    }
+
+    // Formules d'Andrew Simper, "Solving the continuous SVF equations using trapezoidal integration"
+    template <typename NumericType>
+    SvfCoefficients<NumericType> makeSvfSection(SectionShape shape, double sampleRate, float frequency, double q,
+                                                float gainDecibels) noexcept
+    {
+        if (shape == SectionShape::matchedBell)
+        {
+            auto m = makeSvfFromBiquad(makeMatchedPeak(sampleRate, (double) EqFilterDesign::clampFrequency(sampleRate, frequency),
+                                                       q, (double) gainDecibels));
+            return { (NumericType) m.a1, (NumericType) m.a2, (NumericType) m.a3, (NumericType) m.m0, (NumericType) m.m1, (NumericType) m.m2 };
+        }
+
+        // Calcul en double : tan () perd vite en précision en float quand fc / fs est petit
+        auto A = std::pow(10.0, (double) gainDecibels / 40.0);
+        auto g = std::tan(juce::MathConstants<double>::pi * (double) EqFilterDesign::clampFrequency(sampleRate, frequency) / sampleRate);
+        auto k = 1.0 / q;
+        auto m0 = 1.0, m1 = 0.0, m2 = 0.0;
+
+        switch (shape)
+        {
+            case SectionShape::lowShelf:
+                g /= std::sqrt(A);
+                m1 = k * (A - 1.0);
+                m2 = A * A - 1.0;
+                break;
+
+            case SectionShape::highShelf:
+                g *= std::sqrt(A);
+                m0 = A * A;
+                m1 = k * (1.0 - A) * A;
+                m2 = 1.0 - A * A;
+                break;
+
+            case SectionShape::highPass:
+                m1 = -k;
+                m2 = -1.0;
+                break;
+
+            case SectionShape::lowPass:
+                m0 = 0.0;
+                m2 = 1.0;
+                break;
+
+            case SectionShape::notch:
+                m1 = -k;
+                break;
+
+            case SectionShape::matchedBell:
+            case SectionShape::bell:
+            default:
+                k = 1.0 / (q * A);
+                m1 = k * (A * A - 1.0);
+                break;
+        }
+
+        auto a1 = 1.0 / (1.0 + g * (g + k));
+        auto a2 = g * a1;
+
+        SvfCoefficients<NumericType> c;
+        c.a1 = (NumericType) a1;
+        c.a2 = (NumericType) a2;
+        c.a3 = (NumericType) (g * a2);
+        c.m0 = (NumericType) m0;
+        c.m1 = (NumericType) m1;
+        c.m2 = (NumericType) m2;
+        return c;
+    }
+
+    template <typename Coefficients, typename MakeSection>
+    int designSections(FilterType type, float q, Coefficients *sections, MakeSection &&makeSection) noexcept
+    {
+        auto numSections = EqFilterDesign::getNumSections(type);
+        auto shape = getSectionShape(type);
+
+        for (int i = 0; i < numSections; ++i)
+            sections[i] = makeSection(shape, getSectionQ(numSections, i, q));
+
+        return numSections;
+    }
+
+    // Echantillons pour que le pôle le plus lent de la cellule décroisse de decibels dB, plus les deux
+    // échantillons de la partie non récursive ; infini pour un pôle sur ou hors du cercle unité
+    double getSectionRingOutSamples(const BiquadCoefficients<double> &c, double decibels) noexcept
+    {
+        auto discriminant = c.a1 * c.a1 - 4.0 * c.a2;
+        auto radius = discriminant < 0.0 ? std::sqrt(c.a2)
+                                         : (std::abs(c.a1) + std::sqrt(discriminant)) * 0.5;
+
+        if (radius >= 1.0)
+            return std::numeric_limits<double>::infinity();
+
+        if (radius <= 0.0)
+            return 2.0;
+
+        return 2.0 + decibels / (-20.0 * std::log10(radius));
+    }
+
+    // Avec phi = sin²(w / 2) : |H|² = N(phi) / D(phi), deux polynômes du second degré en phi
+    // (forme du "Audio EQ Cookbook"), sans la perte de précision de cos(w) près de 1 en basse fréquence
+    void multiplySectionMagnitudeSquared(const BiquadCoefficients<double> &section, const double *sinSquared,
+                                         double *magnitudeSquared, size_t numPoints) noexcept
+    {
+        auto &c = section;
+        auto n0 = (c.b0 + c.b1 + c.b2) * (c.b0 + c.b1 + c.b2);
+        auto n1 = -4.0 * (c.b0 * c.b1 + 4.0 * c.b0 * c.b2 + c.b1 * c.b2);
+        auto n2 = 16.0 * c.b0 * c.b2;
+        auto d0 = (1.0 + c.a1 + c.a2) * (1.0 + c.a1 + c.a2);
+        auto d1 = -4.0 * (c.a1 + 4.0 * c.a2 + c.a1 * c.a2);
+        auto d2 = 16.0 * c.a2;
+
+        for (size_t i = 0; i < numPoints; ++i)
+        {
+            auto phi = sinSquared[i];
+
+            // Le numérateur d'une encoche peut passer juste sous zéro par arrondi
+            magnitudeSquared[i] *= juce::jmax(0.0, (n0 + phi * (n1 + phi * n2)) / (d0 + phi * (d1 + phi * d2)));
+        }
+    }
+}
+
+namespace EqFilterDesign
+{
+    float clampFrequency(double sampleRate, float frequency) noexcept
+    {
+        return juce::jlimit(2.0f, static_cast<float>(sampleRate * 0.499), frequency);
+    }
+
+    int getNumSections(FilterType type) noexcept
+    {
+        switch (type)
+        {
+            case FilterType::highPass24:
+            case FilterType::lowPass24:   return 2;
+            case FilterType::highPass48:
+            case FilterType::lowPass48:   return 4;
+            case FilterType::bell:
+            case FilterType::lowShelf:
+            case FilterType::highShelf:
+            case FilterType::highPass12:
+            case FilterType::lowPass12:
+            case FilterType::notch:
+            case FilterType::bellMatched: break;
+        }
+
+        return 1;
+    }
+
+    bool hasGain(FilterType type) noexcept
+    {
+        switch (type)
+        {
+            case FilterType::bell:
+            case FilterType::lowShelf:
+            case FilterType::highShelf:
+            case FilterType::bellMatched: return true;
+            case FilterType::highPass12:
+            case FilterType::highPass24:
+            case FilterType::highPass48:
+            case FilterType::lowPass12:
+            case FilterType::lowPass24:
+            case FilterType::lowPass48:
+            case FilterType::notch:       break;
+        }
+
+        return false;
+    }
+
+    template <typename NumericType>
+    int design(FilterType type, double sampleRate, float frequency, float q, float gainDecibels,
+               BiquadCoefficients<NumericType> *sections) noexcept
+    {
+        return designSections(type, q, sections, [&](SectionShape shape, double sectionQ)
+        {
+            return makeBiquadSection<NumericType>(shape, sampleRate, frequency, sectionQ, gainDecibels);
+        });
+    }
+
+    template <typename NumericType>
+    int design(FilterType type, double sampleRate, float frequency, float q, float gainDecibels,
+               SvfCoefficients<NumericType> *sections) noexcept
+    {
+        return designSections(type, q, sections, [&](SectionShape shape, double sectionQ)
+        {
+            return makeSvfSection<NumericType>(shape, sampleRate, frequency, sectionQ, gainDecibels);
+        });
+    }
+
+    void multiplyMagnitudeSquared(FilterType type, double sampleRate, float frequency, float q, float gainDecibels,
+                                  const double *sinSquared, double *magnitudeSquared, size_t numPoints) noexcept
+    {
+        std::array<BiquadCoefficients<double>, maxSectionsPerFilter> sections;
+        auto numSections = design<double>(type, sampleRate, frequency, q, gainDecibels, sections.data());
+
+        for (int s = 0; s < numSections; ++s)
+            multiplySectionMagnitudeSquared(sections[(size_t) s], sinSquared, magnitudeSquared, numPoints);
+    }
+
+    double getRingOutSamples(FilterType type, double sampleRate, float frequency, float q, float gainDecibels,
+                             float decibels) noexcept
+    {
+        std::array<BiquadCoefficients<double>, maxSectionsPerFilter> sections;
+        auto numSections = design<double>(type, sampleRate, frequency, q, gainDecibels, sections.data());
+
+        // Une bande amplifiée peut dépasser le niveau d'entrée avant de décroître : marge du gain en plus
+        auto decay = (double) decibels + (double) juce::jmax(0.0f, gainDecibels);
+        auto samples = 0.0;
+
+        for (int s = 0; s < numSections; ++s)
+            samples += getSectionRingOutSamples(sections[(size_t) s], decay);
+
+        return samples;
+    }
+
+    template int design<float>(FilterType, double, float, float, float, BiquadCoefficients<float> *) noexcept;
+    template int design<double>(FilterType, double, float, float, float, BiquadCoefficients<double> *) noexcept;
+    template int design<float>(FilterType, double, float, float, float, SvfCoefficients<float> *) noexcept;
+    template int design<double>(FilterType, double, float, float, float, SvfCoefficients<double> *) noexcept;
+}
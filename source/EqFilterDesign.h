@@ -0,0 +1,140 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+// Coefficients normalisés (a0 == 1) d'une cellule biquad en forme directe II transposée
+template <typename NumericType>
+struct BiquadCoefficients
+{
+    NumericType b0 = 1;
+    NumericType b1 = 0;
+    NumericType b2 = 0;
+    NumericType a1 = 0;
+    NumericType a2 = 0;
+
+    // Incrément par échantillon pour aller linéairement de *this à target en 1 / scale échantillons
+    BiquadCoefficients getStepTowards(const BiquadCoefficients &target, NumericType scale) const noexcept
+    {
+        return { (target.b0 - b0) * scale, (target.b1 - b1) * scale, (target.b2 - b2) * scale,
+                 (target.a1 - a1) * scale, (target.a2 - a2) * scale };
+    }
+
+    void advance(const BiquadCoefficients &step) noexcept
+    {
+        b0 += step.b0;
+        b1 += step.b1;
+        b2 += step.b2;
+        a1 += step.a1;
+        a2 += step.a2;
+    }
+};
+
+//==============================================================================
+/*  Coefficients d'une cellule à variables d'état TPT (trapèzes, "topology-preserving transform").
+    Notation d'Andrew Simper (Cytomic) : g = tan (pi fc / fs), k = 1 / Q, et
+    a1 = 1 / (1 + g (g + k)), a2 = g a1, a3 = g a2 ; la sortie est m0 v0 + m1 v1 + m2 v2
+    (entrée, passe-bande, passe-bas).
+*/
+template <typename NumericType>
+struct SvfCoefficients
+{
+    NumericType a1 = 1;
+    NumericType a2 = 0;
+    NumericType a3 = 0;
+    NumericType m0 = 1;
+    NumericType m1 = 0;
+    NumericType m2 = 0;
+
+    SvfCoefficients getStepTowards(const SvfCoefficients &target, NumericType scale) const noexcept
+    {
+        return { (target.a1 - a1) * scale, (target.a2 - a2) * scale, (target.a3 - a3) * scale,
+                 (target.m0 - m0) * scale, (target.m1 - m1) * scale, (target.m2 - m2) * scale };
+    }
+
+    void advance(const SvfCoefficients &step) noexcept
+    {
+        a1 += step.a1;
+        a2 += step.a2;
+        a3 += step.a3;
+        m0 += step.m0;
+        m1 += step.m1;
+        m2 += step.m2;
+    }
+};
+
+//==============================================================================
+// Types de bande, dans l'ordre du paramètre EQn_TYPE (le chiffre est la pente en dB/octave)
+enum class FilterType
+{
+    bell,
+    lowShelf,
+    highShelf,
+    highPass12,
+    highPass24,
+    highPass48,
+    lowPass12,
+    lowPass24,
+    lowPass48,
+    notch,
+    bellMatched
+};
+
+//==============================================================================
+/**
+    Calcul des coefficients des bandes, sans allocation.
+
+    design() remplit les cellules du second ordre d'un type de bande dans un tableau
+    fourni par l'appelant, de maxSectionsPerFilter éléments au moins. Les passe-haut et
+    passe-bas de pente supérieure à 12 dB/octave sont des cascades de Butterworth ; le
+    Q de la bande règle la résonance de la dernière cellule (Q = 0,707 donne un
+    Butterworth exact, comme pour la pente de 12 dB/octave).
+
+    La cloche existe en deux versions : transformation bilinéaire (comme
+    IIR::Coefficients::makePeakFilter), dont la réponse se resserre à l'approche de
+    Nyquist, et "matched" (M. Vicanek, "Matched Second Order Digital Filters", 2016),
+    qui suit la cloche analogique jusqu'à Nyquist avec un simple biquad, sans
+    suréchantillonnage ni latence.
+
+    Les fonctions peuvent être appelées depuis le thread audio, y compris plusieurs fois
+    par bloc pendant le lissage. NumericType est float ou double, selon la précision du
+    moteur qui les utilise.
+*/
+namespace EqFilterDesign
+{
+    // Nombre de cellules du type le plus raide (48 dB/octave)
+    constexpr int maxSectionsPerFilter = 4;
+
+    // Dernier type de l'énumération, pour borner les valeurs lues dans les paramètres
+    constexpr FilterType lastFilterType = FilterType::bellMatched;
+
+    int getNumSections(FilterType type) noexcept;
+
+    // Vrai pour les types dont la réponse dépend du gain : cloches et plateaux
+    bool hasGain(FilterType type) noexcept;
+
+    // Le gain n'est utilisé que par la cloche et les plateaux ; renvoie le nombre de cellules écrites
+    template <typename NumericType>
+    int design(FilterType type, double sampleRate, float frequency, float q, float gainDecibels,
+               BiquadCoefficients<NumericType> *sections) noexcept;
+
+    // Les mêmes réponses pour la structure TPT : identiques à la version biquad, mais la structure
+    // reste stable quand les coefficients changent à chaque échantillon et garde sa précision en float
+    // aux basses fréquences
+    template <typename NumericType>
+    int design(FilterType type, double sampleRate, float frequency, float q, float gainDecibels,
+               SvfCoefficients<NumericType> *sections) noexcept;
+
+    // Multiplie magnitudeSquared[i] par le module au carré de la bande (toutes ses cellules) à la
+    // pulsation w telle que sinSquared[i] = sin²(w / 2) ; boucles sans branchement, vectorisées par le compilateur
+    void multiplyMagnitudeSquared(FilterType type, double sampleRate, float frequency, float q, float gainDecibels,
+                                  const double *sinSquared, double *magnitudeSquared, size_t numPoints) noexcept;
+
+    // Durée de résonance de la bande, en échantillons : temps pour que sa réponse impulsionnelle passe
+    // decibels dB sous le niveau d'entrée (pôle le plus lent de chaque cellule, cellules mises bout à bout)
+    double getRingOutSamples(FilterType type, double sampleRate, float frequency, float q, float gainDecibels,
+                             float decibels) noexcept;
+
+    // Fréquence limitée juste sous Nyquist, pour les paramètres à 20 kHz avec une fréquence d'échantillonnage basse
+    float clampFrequency(double sampleRate, float frequency) noexcept;
+}
@@ -0,0 +1,241 @@
+#include "EqLinearPhase.h"
+#include "EqFilterDesign.h"
+
+//==============================================================================
+EqLinearPhase::EqLinearPhase(EqParameters &eqParametersToUse)
+    : juce::Thread("EQ linear phase designer"), eqParameters(eqParametersToUse)
+{
+}
+
+EqLinearPhase::~EqLinearPhase()
+{
+    stopThread(2000);
+}
+
+void EqLinearPhase::prepare(const juce::dsp::ProcessSpec &newSpec)
+{
+    stopThread(2000);
+
+    spec = newSpec;
+    loaded.store(false, std::memory_order_release);
+    convolutions.clear();
+    pendingImpulses.clear();
+    impulsesPending = false;
+    designedLength = 0;
+
+    setEnabled(eqParameters.isLinearPhase());
+}
+
+void EqLinearPhase::setEnabled(bool shouldBeEnabled)
+{
+    if (! shouldBeEnabled)
+    {
+        stopThread(2000);
+        return;
+    }
+
+    // Le thread de fond suit déjà les paramètres ; rien à faire non plus avant prepare()
+    if (isThreadRunning() || spec.numChannels == 0)
+        return;
+
+    if (! isLoaded())
+        load();
+    else if (needsNewImpulse())
+        designImpulse();
+
+    startThread();
+}
+
+void EqLinearPhase::load()
+{
+    auto numChannels = (size_t) spec.numChannels;
+    auto numConvolutions = (numChannels + 1) / 2;
+    pendingImpulses.resize(numConvolutions);
+
+    for (size_t i = 0; i < numConvolutions; ++i)
+        convolutions.push_back(std::make_unique<juce::dsp::Convolution>(juce::dsp::Convolution::NonUniform { headSizeInSamples },
+                                                                        messageQueue));
+
+    floatBuffer.setSize((int) numChannels, (int) spec.maximumBlockSize);
+
+    // Le premier FIR est chargé avant prepare() de chaque convolution, qui l'initialise complètement
+    designImpulse();
+    loadPendingImpulses();
+
+    for (size_t i = 0; i < numConvolutions; ++i)
+        convolutions[i]->prepare({ spec.sampleRate, spec.maximumBlockSize, (juce::uint32) juce::jmin((size_t) 2, numChannels - i * 2) });
+
+    loaded.store(true, std::memory_order_release);
+}
+
+void EqLinearPhase::reset() noexcept
+{
+    for (auto &convolution : convolutions)
+        convolution->reset();
+}
+
+//==============================================================================
+template <typename SampleType>
+void EqLinearPhase::process(const juce::dsp::AudioBlock<SampleType> &block) noexcept
+{
+    loadPendingImpulses();
+
+    if constexpr (std::is_same_v<SampleType, float>)
+    {
+        convolve(block);
+    }
+    else
+    {
+        auto numSamples = block.getNumSamples();
+        auto floatBlock = juce::dsp::AudioBlock<float>(floatBuffer).getSubBlock(0, numSamples)
+                                                                   .getSubsetChannelBlock(0, block.getNumChannels());
+
+        for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+        {
+            auto *source = block.getChannelPointer(channel);
+            auto *destination = floatBlock.getChannelPointer(channel);
+
+            for (size_t i = 0; i < numSamples; ++i)
+                destination[i] = (float) source[i];
+        }
+
+        convolve(floatBlock);
+
+        for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+        {
+            auto *source = floatBlock.getChannelPointer(channel);
+            auto *destination = block.getChannelPointer(channel);
+
+            for (size_t i = 0; i < numSamples; ++i)
+                destination[i] = (SampleType) source[i];
+        }
+    }
+}
+
+void EqLinearPhase::convolve(const juce::dsp::AudioBlock<float> &block) noexcept
+{
+    for (size_t i = 0; i < convolutions.size(); ++i)
+    {
+        auto firstChannel = i * 2;
+
+        if (firstChannel >= block.getNumChannels())
+            break;
+
+        auto pair = block.getSubsetChannelBlock(firstChannel, juce::jmin((size_t) 2, block.getNumChannels() - firstChannel));
+        convolutions[i]->process(juce::dsp::ProcessContextReplacing<float>(pair));
+    }
+}
+
+// Le thread de fond ne garde le verrou que le temps de déplacer des AudioBuffer : au pire,
+// le nouveau FIR est pris au bloc suivant
+void EqLinearPhase::loadPendingImpulses() noexcept
+{
+    const juce::GenericScopedTryLock<juce::SpinLock> lock(pendingLock);
+
+    if (! lock.isLocked() || ! impulsesPending)
+        return;
+
+    // Convolution garde le tampon sans le copier, et libère l'ancien sur son propre thread
+    for (size_t i = 0; i < convolutions.size(); ++i)
+        convolutions[i]->loadImpulseResponse(std::move(pendingImpulses[i]), spec.sampleRate, juce::dsp::Convolution::Stereo::no,
+                                             juce::dsp::Convolution::Trim::no, juce::dsp::Convolution::Normalise::no);
+
+    impulsesPending = false;
+}
+
+//==============================================================================
+void EqLinearPhase::run()
+{
+    while (! threadShouldExit())
+    {
+        if (eqParameters.isLinearPhase() && needsNewImpulse())
+            designImpulse();
+
+        wait(designIntervalMilliseconds);
+    }
+}
+
+bool EqLinearPhase::needsNewImpulse() const noexcept
+{
+    if (eqParameters.getFirLength() != designedLength)
+        return true;
+
+    for (int i = 0; i < EqParameters::numBands; ++i)
+        if (eqParameters.getBand(i).generation.load(std::memory_order_acquire) != designedGenerations[(size_t) i])
+            return true;
+
+    return false;
+}
+
+void EqLinearPhase::designImpulse()
+{
+    // Compteurs relevés avant les valeurs : un changement pendant le calcul en déclenchera un autre
+    for (int i = 0; i < EqParameters::numBands; ++i)
+        designedGenerations[(size_t) i] = eqParameters.getBand(i).generation.load(std::memory_order_acquire);
+
+    auto length = eqParameters.getFirLength();
+    auto numBins = (size_t) length / 2 + 1;
+
+    if (length != designedLength)
+    {
+        fft = std::make_unique<juce::dsp::FFT>(juce::roundToInt(std::log2(length)));
+        spectrum.resize((size_t) length * 2);
+        window.resize((size_t) length);
+        juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), (size_t) length,
+                                                                  juce::dsp::WindowingFunction<float>::blackman, false);
+
+        binSinSquared.resize(numBins);
+        binMagnitudeSquared.resize(numBins);
+
+        for (size_t bin = 0; bin < numBins; ++bin)
+            binSinSquared[bin] = juce::square(std::sin(juce::MathConstants<double>::pi * (double) bin / (double) length));
+
+        designedLength = length;
+    }
+
+    // Module de la réponse de la cascade sur les bins 0 .. length / 2, phase nulle
+    std::fill(binMagnitudeSquared.begin(), binMagnitudeSquared.end(), 1.0);
+
+    for (int i = 0; i < EqParameters::numBands; ++i)
+    {
+        auto &band = eqParameters.getBand(i);
+
+        if (band.on->load() < 0.5f)
+            continue;
+
+        auto type = (FilterType) juce::jlimit(0, (int) EqFilterDesign::lastFilterType, juce::roundToInt(band.type->load()));
+        EqFilterDesign::multiplyMagnitudeSquared(type, spec.sampleRate, band.freq->load(), band.q->load(), band.gain->load(),
+                                                 binSinSquared.data(), binMagnitudeSquared.data(), numBins);
+    }
+
+    std::fill(spectrum.begin(), spectrum.end(), 0.0f);
+
+    for (size_t bin = 0; bin < numBins; ++bin)
+        spectrum[bin * 2] = (float) std::sqrt(binMagnitudeSquared[bin]);
+
+    fft->performRealOnlyInverseTransform(spectrum.data());
+
+    // La réponse à phase nulle est centrée sur l'échantillon 0 (partie négative à la fin) : décalage
+    // circulaire de length / 2, qui devient la latence, puis fenêtrage
+    juce::AudioBuffer<float> impulse(1, length);
+    auto *samples = impulse.getWritePointer(0);
+
+    for (int n = 0; n < length; ++n)
+        samples[n] = spectrum[(size_t) ((n + length / 2) % length)] * window[(size_t) n];
+
+    // Une copie par convolution, préparées ici pour que le thread audio n'ait qu'à les déplacer
+    std::vector<juce::AudioBuffer<float>> impulses(pendingImpulses.size(), impulse);
+
+    {
+        const juce::SpinLock::ScopedLockType lock(pendingLock);
+
+        // Un FIR pas encore pris par le thread audio est simplement remplacé
+        for (size_t i = 0; i < impulses.size(); ++i)
+            pendingImpulses[i] = std::move(impulses[i]);
+
+        impulsesPending = true;
+    }
+}
+
+template void EqLinearPhase::process(const juce::dsp::AudioBlock<float> &) noexcept;
+template void EqLinearPhase::process(const juce::dsp::AudioBlock<double> &) noexcept;
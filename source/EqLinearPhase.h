@@ -0,0 +1,111 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "EqParameters.h"
+
+//==============================================================================
+/**
+    Mode phase linéaire : la réponse en amplitude de toutes les bandes, sans leur phase,
+    appliquée par un FIR symétrique.
+
+    Un thread de fond surveille les paramètres des bandes ; quand ils changent, il
+    échantillonne le module de la réponse de la cascade (mêmes coefficients que le mode
+    phase minimale, voir EqFilterDesign) sur les bins d'une FFT de la longueur du FIR,
+    en fait une réponse impulsionnelle à phase nulle par FFT inverse, la centre et la
+    fenêtre. Le FIR est ensuite remis au thread audio par un SpinLock essayé sans attente,
+    et chargé dans juce::dsp::Convolution (partitionnement non uniforme, sans latence
+    propre), qui prépare le nouveau moteur sur son propre thread et passe de l'ancien
+    au nouveau FIR par un fondu enchaîné.
+
+    Rien de tout cela n'existe en phase minimale : les convolutions sont créées, le
+    premier FIR calculé et chargé et le thread de fond démarré au premier passage en
+    phase linéaire (setEnabled). Tant que isLoaded() est faux, le mode phase minimale
+    reste en place, latence comprise.
+
+    La latence est la moitié de la longueur du FIR, à rapporter à l'hôte avec
+    setLatencySamples() une fois le FIR chargé. Les FIR plus longs résolvent mieux les basses fréquences
+    (la résolution est fs / longueur) au prix de la latence et de la charge CPU.
+
+    Convolution ne traite que deux canaux : une instance par paire de canaux. Le même
+    FIR sert à tous les canaux : le routage des bandes (gauche, droite, milieu, côté)
+    n'existe qu'en phase minimale, ici toutes les bandes agissent en stéréo.
+*/
+class EqLinearPhase : private juce::Thread
+{
+public:
+    explicit EqLinearPhase(EqParameters &eqParameters);
+
+    ~EqLinearPhase() override;
+
+    // Thread de messages, audio arrêté : oublie le FIR chargé, puis appelle setEnabled(isLinearPhase())
+    void prepare(const juce::dsp::ProcessSpec &spec);
+
+    /*  Thread de messages, quand PHASE_MODE change. Le premier passage en phase linéaire après
+        prepare() crée les convolutions et y charge le premier FIR avant de retourner, puis démarre
+        le thread de fond ; le retour en phase minimale arrête le thread et garde le FIR pour la
+        prochaine fois.
+    */
+    void setEnabled(bool shouldBeEnabled);
+
+    // Vrai une fois le premier FIR chargé : le thread audio n'appelle reset() et process() qu'à partir de là
+    bool isLoaded() const noexcept { return loaded.load(std::memory_order_acquire); }
+
+    void reset() noexcept;
+
+    // Latence du traitement pour une longueur de FIR donnée : le centre de la réponse
+    static int getLatencySamples(int firLength) noexcept { return firLength / 2; }
+
+    // Thread audio ; un bloc double passe par une copie float, Convolution ne traitant que des float
+    template <typename SampleType>
+    void process(const juce::dsp::AudioBlock<SampleType> &block) noexcept;
+
+private:
+    void run() override;
+
+    // true si les bandes ou la longueur ont changé depuis le dernier FIR calculé
+    bool needsNewImpulse() const noexcept;
+
+    // Thread de fond (ou prepare()) : calcule un FIR pour les paramètres actuels et le confie au thread audio
+    void designImpulse();
+
+    void loadPendingImpulses() noexcept;
+
+    // Crée et prépare les convolutions avec le premier FIR
+    void load();
+
+    void convolve(const juce::dsp::AudioBlock<float> &block) noexcept;
+
+    // Partitionnement de Convolution : une tête courte en convolution directe par FFT, puis des partitions plus longues
+    static constexpr int headSizeInSamples = 256;
+
+    // Période de surveillance des paramètres par le thread de fond
+    static constexpr int designIntervalMilliseconds = 30;
+
+    EqParameters &eqParameters;
+    juce::dsp::ProcessSpec spec { 44100.0, 0, 0 };
+
+    // Publié après la création des convolutions, lu par le thread audio
+    std::atomic<bool> loaded { false };
+
+    // Doit être détruite après les convolutions qui l'utilisent
+    juce::dsp::ConvolutionMessageQueue messageQueue;
+    std::vector<std::unique_ptr<juce::dsp::Convolution>> convolutions;
+
+    // FIR calculés, un par convolution, en attente du thread audio
+    juce::SpinLock pendingLock;
+    std::vector<juce::AudioBuffer<float>> pendingImpulses;
+    bool impulsesPending = false;
+
+    // État du calcul, propre au thread de fond
+    std::array<juce::uint32, EqParameters::numBands> designedGenerations {};
+    int designedLength = 0;
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<float> spectrum, window;
+    std::vector<double> binSinSquared, binMagnitudeSquared;
+
+    // Copie float d'un bloc double
+    juce::AudioBuffer<float> floatBuffer;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EqLinearPhase)
+};
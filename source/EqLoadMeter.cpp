@@ -0,0 +1,58 @@
+#include "EqLoadMeter.h"
+
+//==============================================================================
+EqLoadMeter::EqLoadMeter(EqLoadMonitor &monitorToUse) : monitor(monitorToUse)
+{
+    if (EqLoadMonitor::isEnabled)
+        startTimerHz(EqLoadMonitor::updateRateHz);
+}
+
+EqLoadMeter::~EqLoadMeter()
+{
+    stopTimer();
+}
+
+void EqLoadMeter::timerCallback()
+{
+    auto &statistics = monitor.getStatistics();
+
+    if (statistics.loadPercent == shown.loadPercent && statistics.p99Percent == shown.p99Percent
+        && statistics.maxPercent == shown.maxPercent && statistics.xrunCount == shown.xrunCount)
+        return;
+
+    shown = statistics;
+    repaint();
+}
+
+void EqLoadMeter::paint(juce::Graphics &g)
+{
+    auto bounds = getLocalBounds().toFloat();
+    auto bar = bounds.removeFromLeft(juce::jmin(80.0f, bounds.getWidth() * 0.4f)).reduced(0.0f, 4.0f);
+
+    g.setColour(juce::Colours::black);
+    g.fillRect(bar);
+
+    auto getColour = [](double percent)
+    {
+        return percent >= criticalPercent ? juce::Colours::red
+                                          : percent >= warningPercent ? juce::Colours::orange : juce::Colours::limegreen;
+    };
+
+    auto getX = [&](double percent) { return bar.getX() + bar.getWidth() * (float) juce::jlimit(0.0, 1.0, percent / 100.0); };
+
+    g.setColour(getColour(shown.loadPercent));
+    g.fillRect(bar.withRight(getX(shown.loadPercent)));
+
+    // Repère du 99e centile : les pointes que la moyenne lissée cache
+    g.setColour(getColour(shown.p99Percent));
+    g.fillRect(juce::Rectangle<float>(getX(shown.p99Percent) - 1.0f, bar.getY(), 2.0f, bar.getHeight()));
+
+    g.setColour(juce::Colours::grey);
+    g.drawRect(bar);
+
+    g.setColour(shown.xrunCount > 0 ? juce::Colours::red : juce::Colours::white);
+    g.setFont(12.0f);
+    g.drawFittedText("DSP " + juce::String(shown.loadPercent, 1) + "%  p99 " + juce::String(shown.p99Percent, 1)
+                         + "%  max " + juce::String(shown.maxPercent, 1) + "%  xruns " + juce::String(shown.xrunCount),
+                     bounds.reduced(6.0f, 0.0f).toNearestInt(), juce::Justification::centredLeft, 1);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "EqLoadMonitor.h"
+
+//==============================================================================
+/**
+    Petit indicateur de charge DSP : barre de la charge lissée, repère du 99e centile de
+    la dernière fenêtre, et en texte la charge, le 99e centile, le maximum et le nombre
+    de xruns. Relu au rythme des statistiques de EqLoadMonitor ; redessiné seulement
+    quand elles ont changé.
+*/
+class EqLoadMeter : public juce::Component,
+                    private juce::Timer
+{
+public:
+    explicit EqLoadMeter(EqLoadMonitor &monitor);
+
+    ~EqLoadMeter() override;
+
+    void paint(juce::Graphics &g) override;
+
+private:
+    void timerCallback() override;
+
+    // Charges au-delà desquelles la barre passe à l'orange puis au rouge, en %
+    static constexpr double warningPercent = 50.0;
+    static constexpr double criticalPercent = 80.0;
+
+    EqLoadMonitor &monitor;
+    EqLoadMonitor::Statistics shown;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EqLoadMeter)
+};
@@ -0,0 +1,108 @@
+#include "EqLoadMonitor.h"
+
+//==============================================================================
+EqLoadMonitor::EqLoadMonitor()
+{
+    if (isEnabled)
+        startTimerHz(updateRateHz);
+}
+
+EqLoadMonitor::~EqLoadMonitor()
+{
+    stopTimer();
+}
+
+void EqLoadMonitor::prepare(double sampleRate, int maximumBlockSize)
+{
+    if (! isEnabled)
+        return;
+
+    // Les compteurs de l'histogramme continuent : seul le timer les lit, par différence
+    measurer.reset(sampleRate, maximumBlockSize);
+
+    nanosecondsToPercent = 100.0 * sampleRate * 1.0e-9;
+}
+
+void EqLoadMonitor::registerBlock(std::chrono::steady_clock::duration duration, int numSamples) noexcept
+{
+    if (numSamples <= 0 || nanosecondsToPercent == 0.0)
+        return;
+
+    auto nanoseconds = (double) std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    measurer.registerRenderTime(nanoseconds * 1.0e-6, numSamples);
+
+    auto percent = (float) (nanoseconds * nanosecondsToPercent / numSamples);
+    auto bin = (size_t) (juce::jmin(percent, (float) (numBins * binWidthPercent)) * (float) (1.0 / binWidthPercent));
+
+    // Seul écrivain : lecture puis écriture, sans lock add
+    counts[bin].store(counts[bin].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    // Maximum de la fenêtre, remis à zéro ici quand le timer l'a lu
+    auto windowMax = windowMaxPercent.load(std::memory_order_relaxed);
+
+    if (windowMaxReset.load(std::memory_order_acquire))
+    {
+        windowMaxReset.store(false, std::memory_order_relaxed);
+        windowMax = 0.0f;
+    }
+
+    windowMaxPercent.store(juce::jmax(windowMax, percent), std::memory_order_relaxed);
+}
+
+void EqLoadMonitor::timerCallback()
+{
+    std::array<juce::uint32, (size_t) numBins + 1> window;
+    juce::uint32 numBlocks = 0;
+
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        auto count = counts[i].load(std::memory_order_relaxed);
+        window[i] = count - previousCounts[i];
+        previousCounts[i] = count;
+        numBlocks += window[i];
+    }
+
+    auto maxPercent = (double) windowMaxPercent.load(std::memory_order_relaxed);
+    windowMaxReset.store(true, std::memory_order_release);
+
+    // Centre de la case où le cumul atteint la proportion voulue ; la dernière case n'a pas de borne haute
+    auto getPercentile = [&](double proportion)
+    {
+        auto target = juce::jmax((juce::uint32) 1, (juce::uint32) std::ceil(proportion * numBlocks));
+        juce::uint32 cumulated = 0;
+
+        for (size_t i = 0; i < (size_t) numBins; ++i)
+        {
+            cumulated += window[i];
+
+            if (cumulated >= target)
+                return juce::jmin(maxPercent, ((double) i + 0.5) * binWidthPercent);
+        }
+
+        return maxPercent;
+    };
+
+    juce::uint32 numOverruns = 0;
+
+    for (auto i = (size_t) (100.0 / binWidthPercent); i < window.size(); ++i)
+        numOverruns += window[i];
+
+    statistics.loadPercent = measurer.getLoadAsPercentage();
+    statistics.xrunCount = measurer.getXRunCount();
+    statistics.numBlocks = (int) numBlocks;
+    statistics.numOverruns = (int) numOverruns;
+
+    if (numBlocks > 0)
+    {
+        statistics.p50Percent = getPercentile(0.5);
+        statistics.p99Percent = getPercentile(0.99);
+        statistics.maxPercent = maxPercent;
+    }
+    else
+    {
+        statistics.p50Percent = statistics.p99Percent = statistics.maxPercent = 0.0;
+    }
+
+    if (onUpdate != nullptr)
+        onUpdate();
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_events/juce_events.h>
+#include <chrono>
+
+// 0 pour retirer la mesure de charge de processBlock (option CMake SDPEQ_LOAD_MONITOR)
+#ifndef SDPEQ_LOAD_MONITOR
+ #define SDPEQ_LOAD_MONITOR 1
+#endif
+
+//==============================================================================
+/**
+    Charge DSP de l'instance : durée de chaque appel de processBlock rapportée à la durée
+    audio du bloc (100 % : le bloc a pris tout le temps dont il disposait).
+
+    Le thread audio lit l'horloge au début et à la fin du bloc (ScopedTimer : steady_clock,
+    à la nanoseconde, là où Time::getHighResolutionTicks s'arrête à la microseconde sous
+    Linux, plus que la durée d'un petit bloc à faible charge), et passe
+    la durée à un juce::AudioProcessLoadMeasurer (charge lissée, nombre de xruns) et à un
+    histogramme de cases de binWidthPercent : chaque case est un compteur atomique à un
+    seul écrivain, incrémenté sans instruction atomique de lecture-écriture. Un timer du
+    thread de messages relit les compteurs updateRateHz fois par seconde et calcule les
+    statistiques de la fenêtre écoulée (médiane, 99e centile, maximum, dépassements de la
+    durée du bloc) par différence avec la lecture précédente : rien n'est jamais remis à
+    zéro depuis l'autre thread.
+
+    Les statistiques sont lues par l'interface et publiées par OSC (onUpdate). Avec
+    SDPEQ_LOAD_MONITOR à 0, ScopedTimer est vide et le timer ne démarre pas.
+*/
+class EqLoadMonitor : private juce::Timer
+{
+public:
+    static constexpr bool isEnabled = SDPEQ_LOAD_MONITOR != 0;
+
+    // Cases de 0,1 % de 0 à 200 % ; la dernière reçoit tous les blocs au-delà
+    static constexpr int numBins = 2000;
+    static constexpr double binWidthPercent = 0.1;
+
+    // Fréquence de calcul des statistiques, et donc durée de leur fenêtre
+    static constexpr int updateRateHz = 4;
+
+    struct Statistics
+    {
+        double loadPercent = 0.0;       // charge lissée de AudioProcessLoadMeasurer
+        double p50Percent = 0.0;
+        double p99Percent = 0.0;
+        double maxPercent = 0.0;
+        int numBlocks = 0;
+        int numOverruns = 0;            // blocs de la fenêtre plus longs que leur durée audio
+        int xrunCount = 0;              // depuis le dernier prepareToPlay
+    };
+
+    EqLoadMonitor();
+
+    ~EqLoadMonitor() override;
+
+    void prepare(double sampleRate, int maximumBlockSize);
+
+#if SDPEQ_LOAD_MONITOR
+    // Thread audio : mesure la durée de vie de l'objet
+    class ScopedTimer
+    {
+    public:
+        ScopedTimer(EqLoadMonitor &monitorToUse, int numSamplesInBlock) noexcept
+            : monitor(monitorToUse), numSamples(numSamplesInBlock), start(std::chrono::steady_clock::now())
+        {
+        }
+
+        ~ScopedTimer() noexcept { monitor.registerBlock(std::chrono::steady_clock::now() - start, numSamples); }
+
+    private:
+        EqLoadMonitor &monitor;
+        int numSamples;
+        std::chrono::steady_clock::time_point start;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedTimer)
+    };
+#else
+    class ScopedTimer
+    {
+    public:
+        ScopedTimer(EqLoadMonitor &, int) noexcept {}
+    };
+#endif
+
+    // Thread de messages : statistiques de la dernière fenêtre
+    const Statistics &getStatistics() const noexcept { return statistics; }
+
+    // Thread de messages, après chaque calcul des statistiques
+    std::function<void()> onUpdate;
+
+private:
+    void registerBlock(std::chrono::steady_clock::duration duration, int numSamples) noexcept;
+
+    void timerCallback() override;
+
+    juce::AudioProcessLoadMeasurer measurer;
+
+    // Conversion d'une durée en nanosecondes en pourcentage d'un bloc d'un échantillon
+    double nanosecondsToPercent = 0.0;
+
+    std::array<std::atomic<juce::uint32>, (size_t) numBins + 1> counts {};
+    std::atomic<float> windowMaxPercent { 0.0f };
+    std::atomic<bool> windowMaxReset { false };
+
+    // Compteurs à la lecture précédente : les différences donnent la fenêtre, même après un débordement
+    std::array<juce::uint32, (size_t) numBins + 1> previousCounts {};
+    Statistics statistics;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EqLoadMonitor)
+};
@@ -0,0 +1,192 @@
+#include "EqOscServer.h"
+
+namespace
+{
+    // Dans l'ordre de EqParameters::BandField
+    const char *const fieldAddresses[] = { "freq", "gain", "q", "on", "topology", "type",
+                                           "dynamic", "threshold", "ratio", "attack", "release", "sidechain",
+                                           "routing" };
+
+    // Fréquence de recopie des valeurs reçues dans l'APVTS
+    constexpr int flushRateHz = 30;
+}
+
+const juce::Identifier EqOscServer::portProperty { "oscPort" };
+const juce::Identifier EqOscServer::loadPortProperty { "oscLoadPort" };
+const juce::Identifier EqOscServer::loadHostProperty { "oscLoadHost" };
+
+//==============================================================================
+EqOscServer::AddressListener::AddressListener(EqOscServer &ownerToUse, int bandIndex, EqParameters::BandField fieldToUse,
+                                              juce::Range<float> rangeToUse)
+    : owner(ownerToUse), band(bandIndex), field(fieldToUse), range(rangeToUse)
+{
+}
+
+void EqOscServer::AddressListener::oscMessageReceived(const juce::OSCMessage &message)
+{
+    if (message.isEmpty())
+        return;
+
+    auto &argument = message[0];
+    float value;
+
+    if (argument.isFloat32())
+        value = argument.getFloat32();
+    else if (argument.isInt32())
+        value = (float) argument.getInt32();
+    else
+        return;
+
+    if (! std::isfinite(value))
+        return;
+
+    // Valeurs discrètes arrondies ici, pour que le thread audio n'ait plus qu'à les recopier
+    if (EqParameters::isToggleField(field))
+        value = value >= 0.5f ? 1.0f : 0.0f;
+    else if (EqParameters::isChoiceField(field))
+        value = (float) juce::roundToInt(value);
+
+    owner.push({ band, field, range.clipValue(value) });
+}
+
+//==============================================================================
+EqOscServer::EqOscServer(EqParameters &eqParametersToUse, juce::AudioProcessorValueTreeState &stateToUse)
+    : eqParameters(eqParametersToUse), state(stateToUse)
+{
+    for (int band = 0; band < EqParameters::numBands; ++band)
+    {
+        for (int f = 0; f < EqParameters::numBandFields; ++f)
+        {
+            auto field = (EqParameters::BandField) f;
+            listeners.push_back(std::make_unique<AddressListener>(*this, band, field, eqParameters.getRange(band, field)));
+
+            auto address = "/eq/" + juce::String(band + 1) + "/" + fieldAddresses[f];
+            receiver.addListener(listeners.back().get(), juce::OSCAddress(address));
+        }
+    }
+
+    state.state.addListener(this);
+    updateConnection();
+}
+
+EqOscServer::~EqOscServer()
+{
+    state.state.removeListener(this);
+    cancelPendingUpdate();
+    stopTimer();
+    receiver.disconnect();
+    loadSender.disconnect();
+
+    for (auto &listener : listeners)
+        receiver.removeListener(listener.get());
+}
+
+void EqOscServer::push(const Change &change) noexcept
+{
+    numReceived.fetch_add(1, std::memory_order_relaxed);
+
+    // Un seul producteur (le thread réseau) et un seul consommateur (le thread audio)
+    const auto scope = fifo.write(1);
+
+    if (scope.blockSize1 > 0)
+        queue[(size_t) scope.startIndex1] = change;
+    else if (scope.blockSize2 > 0)
+        queue[(size_t) scope.startIndex2] = change;
+    else
+        numDropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void EqOscServer::processPendingMessages() noexcept
+{
+    const auto scope = fifo.read(fifo.getNumReady());
+
+    for (int i = 0; i < scope.blockSize1; ++i)
+    {
+        auto &change = queue[(size_t) (scope.startIndex1 + i)];
+        eqParameters.setRemoteValue(change.band, change.field, change.value);
+    }
+
+    for (int i = 0; i < scope.blockSize2; ++i)
+    {
+        auto &change = queue[(size_t) (scope.startIndex2 + i)];
+        eqParameters.setRemoteValue(change.band, change.field, change.value);
+    }
+}
+
+//==============================================================================
+void EqOscServer::updateConnection()
+{
+    updateLoadConnection();
+
+    auto port = (int) state.state.getProperty(portProperty, 0);
+
+    if (port == connectedPort)
+        return;
+
+    receiver.disconnect();
+    connectedPort = 0;
+    stopTimer();
+
+    if (port <= 0)
+        return;
+
+    if (receiver.connect(port))
+    {
+        connectedPort = port;
+        startTimerHz(flushRateHz);
+    }
+}
+
+void EqOscServer::updateLoadConnection()
+{
+    auto port = (int) state.state.getProperty(loadPortProperty, 0);
+    auto host = state.state.getProperty(loadHostProperty, "127.0.0.1").toString();
+
+    if (port == loadPort && host == loadHost)
+        return;
+
+    loadSender.disconnect();
+    loadPort = 0;
+    loadHost = host;
+
+    if (port <= 0)
+        return;
+
+    if (loadSender.connect(host, port))
+        loadPort = port;
+}
+
+void EqOscServer::publishLoad(const EqLoadMonitor::Statistics &statistics)
+{
+    if (loadPort == 0)
+        return;
+
+    loadSender.send(juce::OSCAddressPattern("/eq/load"), (float) statistics.loadPercent, (float) statistics.p50Percent,
+                    (float) statistics.p99Percent, (float) statistics.maxPercent, (juce::int32) statistics.numOverruns,
+                    (juce::int32) statistics.xrunCount);
+}
+
+// L'état peut être modifié hors du thread de messages (restauration par l'hôte) : la connexion se fait toujours de manière asynchrone
+void EqOscServer::valueTreePropertyChanged(juce::ValueTree &, const juce::Identifier &property)
+{
+    if (property == portProperty || property == loadPortProperty || property == loadHostProperty)
+        triggerAsyncUpdate();
+}
+
+void EqOscServer::valueTreeRedirected(juce::ValueTree &)
+{
+    triggerAsyncUpdate();
+}
+
+void EqOscServer::handleAsyncUpdate()
+{
+    updateConnection();
+
+    if (onConnectionChanged != nullptr)
+        onConnectionChanged();
+}
+
+void EqOscServer::timerCallback()
+{
+    eqParameters.flushRemoteValues();
+}
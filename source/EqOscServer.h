@@ -0,0 +1,122 @@
+#pragma once
+
+#include <juce_osc/juce_osc.h>
+#include "EqLoadMonitor.h"
+#include "EqParameters.h"
+
+//==============================================================================
+/**
+    Télécommande OSC des bandes : /eq/<n>/freq, /eq/<n>/gain, /eq/<n>/q, /eq/<n>/on,
+    /eq/<n>/topology et /eq/<n>/type, et pour le mode dynamique /eq/<n>/dynamic,
+    /eq/<n>/threshold, /eq/<n>/ratio, /eq/<n>/attack, /eq/<n>/release et
+    /eq/<n>/sidechain, et /eq/<n>/routing, avec un argument float ou int dans l'unité
+    du paramètre (Hz, dB, Q, 0 / 1, index de structure, de type ou de routage, ms).
+
+    Les messages sont décodés et bornés sur le thread réseau de l'OSCReceiver, puis
+    passent par une file sans verrou à un producteur et un consommateur (AbstractFifo)
+    jusqu'au thread audio, qui la vide au début de chaque bloc avec
+    processPendingMessages() : ni verrou, ni String, ni allocation. Un timer du thread
+    de messages recopie ensuite les valeurs reçues dans l'APVTS (voir
+    EqParameters::flushRemoteValues()).
+
+    Le port est la propriété oscPort de l'état de l'APVTS (0 : désactivé), ce qui le
+    sauvegarde avec le reste du plugin. Un port demandé qui ne peut pas être ouvert laisse
+    isConnected() à false (de même pour l'envoi de la charge et isPublishingLoad()) :
+    l'éditeur compare les deux après chaque onConnectionChanged pour signaler l'échec.
+
+    Dans l'autre sens, la charge DSP (EqLoadMonitor) est envoyée à chaque calcul de ses
+    statistiques vers oscLoadHost:oscLoadPort (127.0.0.1 par défaut ; port 0 : pas
+    d'envoi) : /eq/load avec la charge lissée, la médiane, le 99e centile et le maximum
+    de la fenêtre en % de la durée du bloc (float), puis le nombre de dépassements de la
+    fenêtre et le total des xruns (int).
+*/
+class EqOscServer : private juce::ValueTree::Listener,
+                    private juce::AsyncUpdater,
+                    private juce::Timer
+{
+public:
+    static const juce::Identifier portProperty;
+    static const juce::Identifier loadPortProperty, loadHostProperty;
+
+    // Capacité de la file réseau -> audio ; au-delà, les messages sont perdus (et comptés)
+    static constexpr int queueSize = 1024;
+
+    EqOscServer(EqParameters &eqParameters, juce::AudioProcessorValueTreeState &state);
+
+    ~EqOscServer() override;
+
+    // Thread audio : applique les messages reçus depuis le bloc précédent
+    void processPendingMessages() noexcept;
+
+    bool isConnected() const noexcept { return connectedPort != 0; }
+
+    int getPort() const noexcept { return connectedPort; }
+
+    juce::int64 getNumReceived() const noexcept { return numReceived.load(); }
+
+    juce::int64 getNumDropped() const noexcept { return numDropped.load(); }
+
+    // Thread de messages : envoie /eq/load si un port de destination est réglé
+    void publishLoad(const EqLoadMonitor::Statistics &statistics);
+
+    bool isPublishingLoad() const noexcept { return loadPort != 0; }
+
+    // Thread de messages : appelé après chaque nouvelle tentative de connexion (réception et envoi)
+    std::function<void()> onConnectionChanged;
+
+private:
+    struct Change
+    {
+        int band = 0;
+        EqParameters::BandField field = EqParameters::BandField::freq;
+        float value = 0.0f;
+    };
+
+    class AddressListener : public juce::OSCReceiver::ListenerWithOSCAddress<juce::OSCReceiver::RealtimeCallback>
+    {
+    public:
+        AddressListener(EqOscServer &owner, int band, EqParameters::BandField field, juce::Range<float> range);
+
+        void oscMessageReceived(const juce::OSCMessage &message) override;
+
+    private:
+        EqOscServer &owner;
+        int band;
+        EqParameters::BandField field;
+        juce::Range<float> range;
+    };
+
+    // Thread réseau
+    void push(const Change &change) noexcept;
+
+    void updateConnection();
+
+    void updateLoadConnection();
+
+    void valueTreePropertyChanged(juce::ValueTree &tree, const juce::Identifier &property) override;
+
+    void valueTreeRedirected(juce::ValueTree &tree) override;
+
+    void handleAsyncUpdate() override;
+
+    void timerCallback() override;
+
+    EqParameters &eqParameters;
+    juce::AudioProcessorValueTreeState &state;
+
+    juce::OSCReceiver receiver { "EQ OSC receiver" };
+    std::vector<std::unique_ptr<AddressListener>> listeners;
+    int connectedPort = 0;
+
+    juce::OSCSender loadSender;
+    juce::String loadHost;
+    int loadPort = 0;
+
+    juce::AbstractFifo fifo { queueSize };
+    std::array<Change, (size_t) queueSize> queue;
+
+    std::atomic<juce::int64> numReceived { 0 }, numDropped { 0 };
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EqOscServer)
+};
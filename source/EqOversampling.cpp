@@ -0,0 +1,91 @@
+#include "EqOversampling.h"
+
+//==============================================================================
+EqOversampling::EqOversampling()
+{
+    for (int order = 1; order <= EqParameters::maxOversamplingOrder; ++order)
+    {
+        for (auto linearPhaseFilters : { false, true })
+        {
+            juce::dsp::Oversampling<float> stage(1, (size_t) order, getFilterType(linearPhaseFilters), true, true);
+            latencies[getSettingIndex(order, linearPhaseFilters)] = juce::roundToInt(stage.getLatencyInSamples());
+        }
+    }
+}
+
+void EqOversampling::prepare(const juce::dsp::ProcessSpec &spec, bool doublePrecision)
+{
+    // Les étages de l'autre précision sont libérés : l'hôte ne change de précision qu'avant prepareToPlay
+    auto prepareStages = [&](auto &stages)
+    {
+        using Stage = typename std::remove_reference_t<decltype(stages)>::value_type::element_type;
+
+        for (int order = 1; order <= EqParameters::maxOversamplingOrder; ++order)
+        {
+            for (auto linearPhaseFilters : { false, true })
+            {
+                auto &stage = stages[getSettingIndex(order, linearPhaseFilters)];
+                stage = std::make_unique<Stage>(spec.numChannels, (size_t) order,
+                                                (typename Stage::FilterType) getFilterType(linearPhaseFilters), true, true);
+                stage->initProcessing(spec.maximumBlockSize);
+            }
+        }
+    };
+
+    auto releaseStages = [](auto &stages)
+    {
+        for (auto &stage : stages)
+            stage.reset();
+    };
+
+    if (doublePrecision)
+    {
+        prepareStages(doubleStages);
+        releaseStages(floatStages);
+    }
+    else
+    {
+        prepareStages(floatStages);
+        releaseStages(doubleStages);
+    }
+}
+
+void EqOversampling::reset() noexcept
+{
+    for (auto &stage : floatStages)
+        if (stage != nullptr)
+            stage->reset();
+
+    for (auto &stage : doubleStages)
+        if (stage != nullptr)
+            stage->reset();
+}
+
+int EqOversampling::getLatencySamples(int order, bool linearPhaseFilters) const noexcept
+{
+    return order > 0 ? latencies[getSettingIndex(order, linearPhaseFilters)] : 0;
+}
+
+template <typename SampleType>
+juce::dsp::Oversampling<SampleType> &EqOversampling::getStage(int order, bool linearPhaseFilters) noexcept
+{
+    if constexpr (std::is_same_v<SampleType, float>)
+        return *floatStages[getSettingIndex(order, linearPhaseFilters)];
+    else
+        return *doubleStages[getSettingIndex(order, linearPhaseFilters)];
+}
+
+size_t EqOversampling::getSettingIndex(int order, bool linearPhaseFilters) noexcept
+{
+    jassert(order >= 1 && order <= EqParameters::maxOversamplingOrder);
+    return (size_t) (order - 1) * 2 + (linearPhaseFilters ? 1 : 0);
+}
+
+juce::dsp::Oversampling<float>::FilterType EqOversampling::getFilterType(bool linearPhaseFilters) noexcept
+{
+    return linearPhaseFilters ? juce::dsp::Oversampling<float>::filterHalfBandFIREquiripple
+                              : juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR;
+}
+
+template juce::dsp::Oversampling<float> &EqOversampling::getStage(int, bool) noexcept;
+template juce::dsp::Oversampling<double> &EqOversampling::getStage(int, bool) noexcept;
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include "EqParameters.h"
+
+//==============================================================================
+/**
+    Suréchantillonnage du mode phase minimale, appliqué autour de toute la cascade :
+    un seul aller-retour par bloc, quel que soit le nombre de bandes. A 2x ou 4x, les
+    cloches proches de Nyquist ne sont plus resserrées par la transformation bilinéaire.
+
+    Un juce::dsp::Oversampling est préparé dans prepare() pour chaque facteur et chaque
+    famille de filtres (IIR polyphase à latence minimale, FIR équiripple à phase
+    linéaire) : changer de réglage pendant la lecture n'alloue rien, le thread audio
+    passe simplement à un autre étage. Seule la précision utilisée par l'hôte est préparée.
+
+    La latence de chaque réglage est arrondie à un nombre entier d'échantillons par
+    Oversampling lui-même (retard fractionnaire ajouté en sortie), pour que la
+    compensation de l'hôte soit exacte.
+*/
+class EqOversampling
+{
+public:
+    EqOversampling();
+
+    // Thread de messages, audio arrêté
+    void prepare(const juce::dsp::ProcessSpec &spec, bool doublePrecision);
+
+    void reset() noexcept;
+
+    // Latence pour un ordre (0 : pas de suréchantillonnage) et une famille de filtres, en échantillons à la fréquence de base
+    int getLatencySamples(int order, bool linearPhaseFilters) const noexcept;
+
+    // Thread audio : étage préparé pour ce réglage (order >= 1), dans la précision passée à prepare()
+    template <typename SampleType>
+    juce::dsp::Oversampling<SampleType> &getStage(int order, bool linearPhaseFilters) noexcept;
+
+private:
+    static constexpr size_t numSettings = (size_t) EqParameters::maxOversamplingOrder * 2;
+
+    static size_t getSettingIndex(int order, bool linearPhaseFilters) noexcept;
+
+    static juce::dsp::Oversampling<float>::FilterType getFilterType(bool linearPhaseFilters) noexcept;
+
+    template <typename SampleType>
+    using Stages = std::array<std::unique_ptr<juce::dsp::Oversampling<SampleType>>, numSettings>;
+
+    Stages<float> floatStages;
+    Stages<double> doubleStages;
+
+    // Ne dépend que du facteur et des filtres : calculée une fois, lisible avant prepare()
+    std::array<int, numSettings> latencies {};
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EqOversampling)
+};
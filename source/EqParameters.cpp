@@ -0,0 +1,286 @@
+#include "EqParameters.h"
+
+namespace
+{
+    const char *const bandParameterSuffixes[] = { "FREQ", "GAIN", "Q", "ON", "TOPOLOGY", "TYPE",
+                                                  "DYN", "THRESHOLD", "RATIO", "ATTACK", "RELEASE", "SIDECHAIN", "ROUTING" };
+
+    // Dans l'ordre de getSmoothingChoices()
+    const int smoothingIntervals[] = { 0, 8, 16, 32 };
+
+    // Dans l'ordre de getFirLengthChoices()
+    const int firLengths[] = { 4096, 8192, 16384, 32768, 65536 };
+
+    // Vrai pendant que flushRemoteValues() recopie une valeur dans l'APVTS, sur ce thread-là :
+    // la copie lue par le thread audio a déjà cette valeur, ou une plus récente
+    thread_local bool flushingRemoteValue = false;
+
+    // Plage logarithmique : la moitié de la course du paramètre couvre autant d'octaves que l'autre
+    juce::NormalisableRange<float> logRange(float minimum, float maximum)
+    {
+        auto octaves = std::log(maximum / minimum);
+
+        return { minimum, maximum,
+                 [=](float start, float, float v) { return std::exp(v * octaves) * start; },
+                 [=](float start, float, float v) { return std::log(v / start) / octaves; } };
+    }
+}
+
+//==============================================================================
+EqParameters::EqParameters(juce::AudioProcessorValueTreeState &stateToUse)
+    : state(stateToUse)
+{
+    for (int i = 0; i < numBands; ++i)
+    {
+        auto &band = bands[(size_t) i];
+
+        for (size_t field = 0; field < (size_t) numBandFields; ++field)
+        {
+            auto id = getParameterID(i, bandParameterSuffixes[field]);
+            band.parameters[field] = state.getParameter(id);
+            jassert(band.parameters[field] != nullptr);
+
+            band.values[field].store(state.getRawParameterValue(id)->load());
+            band.remotePending[field].store(false);
+            state.addParameterListener(id, this);
+        }
+
+        band.freq = &band.values[(size_t) BandField::freq];
+        band.gain = &band.values[(size_t) BandField::gain];
+        band.q = &band.values[(size_t) BandField::q];
+        band.on = &band.values[(size_t) BandField::on];
+        band.topology = &band.values[(size_t) BandField::topology];
+        band.type = &band.values[(size_t) BandField::type];
+        band.dynamic = &band.values[(size_t) BandField::dynamic];
+        band.threshold = &band.values[(size_t) BandField::threshold];
+        band.ratio = &band.values[(size_t) BandField::ratio];
+        band.attack = &band.values[(size_t) BandField::attack];
+        band.release = &band.values[(size_t) BandField::release];
+        band.sidechain = &band.values[(size_t) BandField::sidechain];
+        band.routing = &band.values[(size_t) BandField::routing];
+    }
+
+    smoothing = state.getRawParameterValue("SMOOTHING");
+    bypassFade = state.getRawParameterValue("BYPASS_FADE");
+    phaseMode = state.getRawParameterValue("PHASE_MODE");
+    firLength = state.getRawParameterValue("FIR_LENGTH");
+    oversampling = state.getRawParameterValue("OVERSAMPLING");
+    oversamplingFilter = state.getRawParameterValue("OVERSAMPLING_FILTER");
+    jassert(smoothing != nullptr && bypassFade != nullptr && phaseMode != nullptr && firLength != nullptr
+            && oversampling != nullptr && oversamplingFilter != nullptr);
+}
+
+EqParameters::~EqParameters()
+{
+    for (int i = 0; i < numBands; ++i)
+        for (auto *suffix : bandParameterSuffixes)
+            state.removeParameterListener(getParameterID(i, suffix), this);
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout EqParameters::createParameterLayout()
+{
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+
+    for (int i = 0; i < numBands; ++i)
+    {
+        auto name = "EQ" + juce::String(i + 1);
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(getParameterID(i, BandField::freq), name + " Frequency",
+                                                               logRange(20.0f, 20000.0f), getDefaultFrequency(i)),
+                   std::make_unique<juce::AudioParameterFloat>(getParameterID(i, BandField::gain), name + " Gain", -24.0f, 24.0f, 0.0f),
+                   std::make_unique<juce::AudioParameterFloat>(getParameterID(i, BandField::q), name + " Q", 0.1f, 10.0f, 1.0f),
+                   std::make_unique<juce::AudioParameterBool>(getParameterID(i, BandField::on), name + " On", true),
+                   std::make_unique<juce::AudioParameterChoice>(getParameterID(i, BandField::topology), name + " Topology",
+                                                                getTopologyChoices(), 0),
+                   std::make_unique<juce::AudioParameterChoice>(getParameterID(i, BandField::type), name + " Type",
+                                                                getTypeChoices(), 0));
+
+        // Mode dynamique : désactivé par défaut, la bande reste statique
+        layout.add(std::make_unique<juce::AudioParameterBool>(getParameterID(i, BandField::dynamic), name + " Dynamic", false),
+                   std::make_unique<juce::AudioParameterFloat>(getParameterID(i, BandField::threshold), name + " Threshold",
+                                                               juce::NormalisableRange<float>(-60.0f, 0.0f, 0.1f), -24.0f, "dB"),
+                   std::make_unique<juce::AudioParameterFloat>(getParameterID(i, BandField::ratio), name + " Ratio",
+                                                               logRange(1.0f, 20.0f), 4.0f),
+                   std::make_unique<juce::AudioParameterFloat>(getParameterID(i, BandField::attack), name + " Attack",
+                                                               logRange(0.1f, 100.0f), 5.0f, "ms"),
+                   std::make_unique<juce::AudioParameterFloat>(getParameterID(i, BandField::release), name + " Release",
+                                                               logRange(5.0f, 1000.0f), 100.0f, "ms"),
+                   std::make_unique<juce::AudioParameterBool>(getParameterID(i, BandField::sidechain), name + " Sidechain", false));
+
+        // Canaux traités : les deux canaux de chaque paire par défaut. Gauche, droite, milieu et côté ne s'appliquent
+        // qu'aux vraies paires gauche / droite de la disposition (avant, surround...) ; les autres canaux restent en stéréo
+        layout.add(std::make_unique<juce::AudioParameterChoice>(getParameterID(i, BandField::routing), name + " Routing",
+                                                                getRoutingChoices(), 0));
+    }
+
+    // Lissage des paramètres : intervalle de recalcul des coefficients pendant une rampe
+    layout.add(std::make_unique<juce::AudioParameterChoice>("SMOOTHING", "Smoothing", getSmoothingChoices(), 2));
+
+    // Durée du fondu des kill switches
+    layout.add(std::make_unique<juce::AudioParameterFloat>("BYPASS_FADE", "Bypass Fade", juce::NormalisableRange<float>(0.0f, 100.0f, 0.1f),
+                                                           10.0f, "ms"));
+
+    // Phase linéaire : FIR de 16384 échantillons par défaut (latence de 171 ms à 48 kHz)
+    layout.add(std::make_unique<juce::AudioParameterChoice>("PHASE_MODE", "Phase Mode", getPhaseModeChoices(), 0),
+               std::make_unique<juce::AudioParameterChoice>("FIR_LENGTH", "Linear Phase FIR Length", getFirLengthChoices(), 2));
+
+    // Suréchantillonnage : désactivé par défaut, filtres IIR (latence minimale)
+    layout.add(std::make_unique<juce::AudioParameterChoice>("OVERSAMPLING", "Oversampling", getOversamplingChoices(), 0),
+               std::make_unique<juce::AudioParameterChoice>("OVERSAMPLING_FILTER", "Oversampling Filter",
+                                                            getOversamplingFilterChoices(), 0));
+
+    return layout;
+}
+
+float EqParameters::getDefaultFrequency(int bandIndex) noexcept
+{
+    if (numBands == 2)
+        return bandIndex == 0 ? 1000.0f : 5000.0f;
+
+    // Espacement logarithmique entre 50 Hz et 12 kHz
+    auto position = numBands > 1 ? (float) bandIndex / (float) (numBands - 1) : 0.5f;
+    return 50.0f * std::pow(12000.0f / 50.0f, position);
+}
+
+int EqParameters::getSmoothingInterval() const noexcept
+{
+    auto index = juce::jlimit(0, (int) std::size(smoothingIntervals) - 1, juce::roundToInt(smoothing->load()));
+    return smoothingIntervals[index];
+}
+
+juce::StringArray EqParameters::getSmoothingChoices()
+{
+    return { "Off", "8 samples", "16 samples", "32 samples" };
+}
+
+juce::StringArray EqParameters::getPhaseModeChoices()
+{
+    return { "Minimum Phase", "Linear Phase" };
+}
+
+int EqParameters::getFirLength() const noexcept
+{
+    auto index = juce::jlimit(0, (int) std::size(firLengths) - 1, juce::roundToInt(firLength->load()));
+    return firLengths[index];
+}
+
+juce::StringArray EqParameters::getFirLengthChoices()
+{
+    juce::StringArray choices;
+
+    for (auto length : firLengths)
+        choices.add(juce::String(length));
+
+    return choices;
+}
+
+int EqParameters::getOversamplingOrder() const noexcept
+{
+    return juce::jlimit(0, maxOversamplingOrder, juce::roundToInt(oversampling->load()));
+}
+
+juce::StringArray EqParameters::getOversamplingChoices()
+{
+    return { "Off", "2x", "4x" };
+}
+
+juce::StringArray EqParameters::getOversamplingFilterChoices()
+{
+    return { "Polyphase IIR", "Linear Phase FIR" };
+}
+
+juce::StringArray EqParameters::getTopologyChoices()
+{
+    return { "Biquad", "TPT SVF" };
+}
+
+juce::StringArray EqParameters::getTypeChoices()
+{
+    return { "Bell", "Low Shelf", "High Shelf", "High Pass 12", "High Pass 24", "High Pass 48",
+             "Low Pass 12", "Low Pass 24", "Low Pass 48", "Notch", "Bell (Matched)" };
+}
+
+juce::StringArray EqParameters::getRoutingChoices()
+{
+    return { "Stereo", "Left", "Right", "Mid", "Side" };
+}
+
+juce::String EqParameters::getParameterID(int bandIndex, const char *suffix)
+{
+    return "EQ" + juce::String(bandIndex + 1) + "_" + suffix;
+}
+
+juce::String EqParameters::getParameterID(int bandIndex, BandField field)
+{
+    return getParameterID(bandIndex, bandParameterSuffixes[(size_t) field]);
+}
+
+juce::Range<float> EqParameters::getRange(int bandIndex, BandField field) const noexcept
+{
+    auto &range = bands[(size_t) bandIndex].parameters[(size_t) field]->getNormalisableRange();
+    return { range.start, range.end };
+}
+
+void EqParameters::setRemoteValue(int bandIndex, BandField field, float value) noexcept
+{
+    auto &band = bands[(size_t) bandIndex];
+    band.values[(size_t) field].store(value);
+    band.remotePending[(size_t) field].store(true, std::memory_order_release);
+    band.generation.fetch_add(1, std::memory_order_release);
+}
+
+void EqParameters::flushRemoteValues()
+{
+    for (auto &band : bands)
+    {
+        for (size_t field = 0; field < (size_t) numBandFields; ++field)
+        {
+            if (! band.remotePending[field].exchange(false, std::memory_order_acquire))
+                continue;
+
+            auto *parameter = band.parameters[field];
+            auto value = band.values[field].load();
+
+            // Un geste par changement, pour que l'hôte puisse enregistrer l'automation
+            const juce::ScopedValueSetter<bool> flushing(flushingRemoteValue, true);
+            parameter->beginChangeGesture();
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+            parameter->endChangeGesture();
+        }
+    }
+}
+
+// Peut être appelée depuis n'importe quel thread (automation de l'hôte, interface, restauration d'état) :
+// on met à jour la copie de la valeur et le compteur de la bande concernée, sans allocation ni verrou
+void EqParameters::parameterChanged(const juce::String &parameterID, float newValue)
+{
+    // "EQ<n>_..." : lecture du numéro de bande directement dans la chaîne, sans créer de String
+    auto text = parameterID.getCharPointer();
+
+    if (text.getAndAdvance() != 'E' || text.getAndAdvance() != 'Q')
+        return;
+
+    int bandNumber = 0;
+
+    while (text.isDigit())
+        bandNumber = bandNumber * 10 + (int) (text.getAndAdvance() - '0');
+
+    if (bandNumber < 1 || bandNumber > numBands || text.getAndAdvance() != '_')
+        return;
+
+    auto &band = bands[(size_t) bandNumber - 1];
+
+    if (! flushingRemoteValue)
+    {
+        for (size_t field = 0; field < (size_t) numBandFields; ++field)
+        {
+            if (text.compare(juce::CharPointer_ASCII(bandParameterSuffixes[field])) == 0)
+            {
+                band.values[field].store(newValue);
+                break;
+            }
+        }
+    }
+
+    band.generation.fetch_add(1, std::memory_order_release);
+}
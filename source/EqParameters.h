@@ -0,0 +1,179 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+// Nombre de bandes, fixé à la compilation (option CMake SDPEQ_NUM_BANDS) ; 2 donne l'EQ "Dual" d'origine
+#ifndef SDPEQ_NUM_BANDS
+ #define SDPEQ_NUM_BANDS 2
+#endif
+
+//==============================================================================
+/**
+    Liaison entre l'AudioProcessorValueTreeState et le thread audio.
+
+    Les paramètres sont résolus une seule fois dans le constructeur, ce qui évite les
+    recherches par chaîne de caractères dans processBlock. Chaque bande possède aussi
+    un compteur de génération, incrémenté sans verrou par parameterChanged(), qui
+    permet au thread audio de savoir si quelque chose a bougé depuis le dernier bloc.
+
+    Le thread audio lit une copie des valeurs des bandes, tenue à jour par
+    parameterChanged() : une télécommande (OSC) peut ainsi modifier une bande
+    directement depuis le thread audio avec setRemoteValue(), sans passer par
+    l'APVTS. flushRemoteValues() recopie ensuite ces valeurs dans les paramètres
+    depuis le thread de messages, pour que l'hôte, l'interface et l'état sauvegardé
+    les voient aussi.
+*/
+class EqParameters : private juce::AudioProcessorValueTreeState::Listener
+{
+public:
+    static constexpr int numBands = SDPEQ_NUM_BANDS;
+
+    static_assert(numBands >= 1 && numBands <= 32, "SDPEQ_NUM_BANDS must be between 1 and 32");
+
+    // Dans l'ordre des suffixes d'identifiant : FREQ, GAIN, Q, ON, TOPOLOGY, TYPE, puis le mode dynamique :
+    // DYN, THRESHOLD, RATIO, ATTACK, RELEASE, SIDECHAIN, et enfin ROUTING
+    enum class BandField
+    {
+        freq,
+        gain,
+        q,
+        on,
+        topology,
+        type,
+        dynamic,
+        threshold,
+        ratio,
+        attack,
+        release,
+        sidechain,
+        routing
+    };
+
+    static constexpr int numBandFields = 13;
+
+    // Champs booléens (interrupteurs) et à choix, arrondis à la réception d'une valeur distante
+    static bool isToggleField(BandField field) noexcept
+    {
+        return field == BandField::on || field == BandField::dynamic || field == BandField::sidechain;
+    }
+
+    static bool isChoiceField(BandField field) noexcept
+    {
+        return field == BandField::topology || field == BandField::type || field == BandField::routing;
+    }
+
+    struct Band
+    {
+        // Pointent dans values
+        std::atomic<float>* freq = nullptr;
+        std::atomic<float>* gain = nullptr;
+        std::atomic<float>* q = nullptr;
+        std::atomic<float>* on = nullptr;
+        std::atomic<float>* topology = nullptr;
+        std::atomic<float>* type = nullptr;
+
+        // Mode dynamique (EqDynamics) : le gain de la bande devient la profondeur maximale
+        std::atomic<float>* dynamic = nullptr;
+        std::atomic<float>* threshold = nullptr;
+        std::atomic<float>* ratio = nullptr;
+        std::atomic<float>* attack = nullptr;
+        std::atomic<float>* release = nullptr;
+        std::atomic<float>* sidechain = nullptr;
+
+        // Canaux traités par la bande, dans l'ordre de ChannelRouting ; seulement dans les vraies paires gauche / droite
+        std::atomic<float>* routing = nullptr;
+
+        // Incrémenté à chaque changement d'un des paramètres de la bande
+        std::atomic<juce::uint32> generation { 1 };
+
+        std::array<std::atomic<float>, numBandFields> values;
+
+        // Valeurs modifiées par setRemoteValue() et pas encore recopiées dans les paramètres
+        std::array<std::atomic<bool>, numBandFields> remotePending;
+
+        std::array<juce::RangedAudioParameter*, numBandFields> parameters {};
+    };
+
+    explicit EqParameters(juce::AudioProcessorValueTreeState &state);
+
+    // Tous les paramètres du plugin : EQ<n>_FREQ / GAIN / Q / ON / TOPOLOGY / TYPE et EQ<n>_DYN / THRESHOLD /
+    // RATIO / ATTACK / RELEASE / SIDECHAIN et EQ<n>_ROUTING pour chaque bande, puis les réglages globaux
+    static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+
+    // Fréquence par défaut d'une bande : 1 kHz et 5 kHz en version deux bandes, sinon réparties sur le spectre
+    static float getDefaultFrequency(int bandIndex) noexcept;
+
+    ~EqParameters() override;
+
+    Band &getBand(int index) noexcept { return bands[(size_t) index]; }
+
+    const Band &getBand(int index) const noexcept { return bands[(size_t) index]; }
+
+    // Plage d'un paramètre de bande, pour valider les valeurs reçues à distance
+    juce::Range<float> getRange(int bandIndex, BandField field) const noexcept;
+
+    // Thread audio : applique une valeur (dans l'unité du paramètre) dès le prochain bloc, sans verrou ni allocation
+    void setRemoteValue(int bandIndex, BandField field, float value) noexcept;
+
+    // Thread de messages : reporte dans l'APVTS les valeurs reçues par setRemoteValue()
+    void flushRemoteValues();
+
+    // Intervalle de recalcul des coefficients pendant une rampe, en échantillons (0 = pas de lissage)
+    int getSmoothingInterval() const noexcept;
+
+    static juce::StringArray getSmoothingChoices();
+
+    // Durée du fondu d'activation / désactivation des bandes, en millisecondes
+    float getBypassFadeTime() const noexcept { return bypassFade->load(); }
+
+    // Dans l'ordre de EqBand::Topology
+    static juce::StringArray getTopologyChoices();
+
+    // Dans l'ordre de FilterType
+    static juce::StringArray getTypeChoices();
+
+    // Dans l'ordre de ChannelRouting
+    static juce::StringArray getRoutingChoices();
+
+    // Mode phase linéaire (EqLinearPhase) plutôt que les filtres récursifs à phase minimale
+    bool isLinearPhase() const noexcept { return phaseMode->load() >= 0.5f; }
+
+    static juce::StringArray getPhaseModeChoices();
+
+    // Longueur du FIR du mode phase linéaire, en échantillons (puissance de deux)
+    int getFirLength() const noexcept;
+
+    static juce::StringArray getFirLengthChoices();
+
+    // Suréchantillonnage du mode phase minimale : facteur 2 ^ ordre (0 = désactivé)
+    int getOversamplingOrder() const noexcept;
+
+    static constexpr int maxOversamplingOrder = 2;
+
+    static juce::StringArray getOversamplingChoices();
+
+    // Filtres de suréchantillonnage : FIR à phase linéaire plutôt que IIR polyphase à latence minimale
+    bool isOversamplingFilterLinearPhase() const noexcept { return oversamplingFilter->load() >= 0.5f; }
+
+    static juce::StringArray getOversamplingFilterChoices();
+
+    // Identifiant APVTS d'un paramètre de bande, par exemple getParameterID(0, "FREQ") == "EQ1_FREQ"
+    static juce::String getParameterID(int bandIndex, const char *suffix);
+
+    static juce::String getParameterID(int bandIndex, BandField field);
+
+private:
+    void parameterChanged(const juce::String &parameterID, float newValue) override;
+
+    juce::AudioProcessorValueTreeState &state;
+    std::array<Band, numBands> bands;
+    std::atomic<float>* smoothing = nullptr;
+    std::atomic<float>* bypassFade = nullptr;
+    std::atomic<float>* phaseMode = nullptr;
+    std::atomic<float>* firLength = nullptr;
+    std::atomic<float>* oversampling = nullptr;
+    std::atomic<float>* oversamplingFilter = nullptr;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EqParameters)
+};
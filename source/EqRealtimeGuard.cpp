@@ -0,0 +1,290 @@
+// Les versions "fortifiées" de open() et read() sont des fonctions inline des en-têtes : pas de redéfinition possible
+#ifdef _FORTIFY_SOURCE
+ #undef _FORTIFY_SOURCE
+#endif
+
+#include "EqRealtimeGuard.h"
+
+#if SDPEQ_REALTIME_GUARD
+
+#if ! defined(__linux__) || ! defined(__GLIBC__)
+ #error "SDPEQ_REALTIME_GUARD needs Linux and glibc"
+#endif
+
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+// Allocateur de la glibc, appelé directement : dlsym() peut lui-même allouer
+extern "C"
+{
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t count, size_t size);
+    void *__libc_realloc(void *pointer, size_t size);
+    void *__libc_memalign(size_t alignment, size_t size);
+    void __libc_free(void *pointer);
+}
+
+namespace
+{
+    // initial-exec : lisible depuis malloc sans passer par __tls_get_addr, qui peut allouer
+    thread_local bool inAudioCallback __attribute__((tls_model("initial-exec"))) = false;
+
+    std::atomic<juce::int64> numViolations { 0 };
+    bool abortOnViolation = true;
+
+    struct Initialiser
+    {
+        Initialiser() noexcept
+        {
+            auto *mode = std::getenv("SDPEQ_REALTIME_GUARD");
+            abortOnViolation = mode == nullptr || std::strcmp(mode, "report") != 0;
+
+            // Le premier appel de backtrace() charge libgcc_s : pas pendant un rapport
+            void *frames[1];
+            backtrace(frames, 1);
+        }
+    };
+
+    Initialiser initialiser;
+
+    // Le rapport lui-même écrit et peut allouer : le drapeau est levé pendant ce temps
+    void reportViolation(const char *function) noexcept
+    {
+        inAudioCallback = false;
+        ++numViolations;
+
+        char message[160];
+        auto length = std::snprintf(message, sizeof(message), "SDPEQ_REALTIME_GUARD: %s() called from processBlock\n", function);
+        ::write(STDERR_FILENO, message, (size_t) juce::jlimit(0, (int) sizeof(message) - 1, length));
+
+        void *frames[64];
+        backtrace_symbols_fd(frames, backtrace(frames, 64), STDERR_FILENO);
+
+        if (abortOnViolation)
+            std::abort();
+
+        inAudioCallback = true;
+    }
+
+    void check(const char *function) noexcept
+    {
+        if (inAudioCallback)
+            reportViolation(function);
+    }
+
+    // Fonction suivante du même nom (celle de la libc), cherchée au premier appel. Pas de variable
+    // statique locale : son initialisation peut elle-même prendre un verrou
+    template <typename Function>
+    struct NextFunction
+    {
+        const char *name;
+        std::atomic<Function> function { nullptr };
+
+        Function get() noexcept
+        {
+            auto next = function.load(std::memory_order_relaxed);
+
+            if (next == nullptr)
+            {
+                next = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+                function.store(next, std::memory_order_relaxed);
+            }
+
+            return next;
+        }
+    };
+
+    NextFunction<int (*)(pthread_mutex_t *)> nextMutexLock { "pthread_mutex_lock" };
+    NextFunction<int (*)(pthread_rwlock_t *)> nextReadLock { "pthread_rwlock_rdlock" };
+    NextFunction<int (*)(pthread_rwlock_t *)> nextWriteLock { "pthread_rwlock_wrlock" };
+    NextFunction<int (*)(pthread_cond_t *, pthread_mutex_t *)> nextConditionWait { "pthread_cond_wait" };
+    NextFunction<int (*)(pthread_cond_t *, pthread_mutex_t *, const struct timespec *)> nextConditionTimedWait { "pthread_cond_timedwait" };
+    NextFunction<int (*)(sem_t *)> nextSemaphoreWait { "sem_wait" };
+    NextFunction<int (*)(const char *, int, ...)> nextOpen { "open" };
+    NextFunction<FILE *(*)(const char *, const char *)> nextFileOpen { "fopen" };
+    NextFunction<ssize_t (*)(int, void *, size_t)> nextRead { "read" };
+    NextFunction<ssize_t (*)(int, const void *, size_t)> nextWrite { "write" };
+    NextFunction<int (*)(const struct timespec *, struct timespec *)> nextSleep { "nanosleep" };
+    NextFunction<int (*)(useconds_t)> nextMicrosecondSleep { "usleep" };
+    NextFunction<int (*)()> nextYield { "sched_yield" };
+    NextFunction<void *(*)(void *, size_t, int, int, int, off_t)> nextMap { "mmap" };
+}
+
+//==============================================================================
+namespace EqRealtimeGuard
+{
+    ScopedAudioCallback::ScopedAudioCallback() noexcept : wasInAudioCallback(inAudioCallback)
+    {
+        inAudioCallback = true;
+    }
+
+    ScopedAudioCallback::~ScopedAudioCallback() noexcept
+    {
+        inAudioCallback = wasInAudioCallback;
+    }
+
+    juce::int64 getNumViolations() noexcept
+    {
+        return numViolations.load();
+    }
+}
+
+//==============================================================================
+// Allocations
+extern "C" void *malloc(size_t size) __THROW
+{
+    check("malloc");
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size) __THROW
+{
+    check("calloc");
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *pointer, size_t size) __THROW
+{
+    check("realloc");
+    return __libc_realloc(pointer, size);
+}
+
+extern "C" void free(void *pointer) __THROW
+{
+    if (pointer != nullptr)
+        check("free");
+
+    __libc_free(pointer);
+}
+
+extern "C" void *memalign(size_t alignment, size_t size) __THROW
+{
+    check("memalign");
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" void *aligned_alloc(size_t alignment, size_t size) __THROW
+{
+    check("aligned_alloc");
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void **result, size_t alignment, size_t size) __THROW
+{
+    check("posix_memalign");
+
+    if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0)
+        return EINVAL;
+
+    *result = __libc_memalign(alignment, size);
+    return *result != nullptr || size == 0 ? 0 : ENOMEM;
+}
+
+//==============================================================================
+// Verrous qui peuvent attendre (les try-lock ne bloquent jamais, ils restent permis)
+extern "C" int pthread_mutex_lock(pthread_mutex_t *mutex) __THROWNL
+{
+    check("pthread_mutex_lock");
+    return nextMutexLock.get()(mutex);
+}
+
+extern "C" int pthread_rwlock_rdlock(pthread_rwlock_t *lock) __THROWNL
+{
+    check("pthread_rwlock_rdlock");
+    return nextReadLock.get()(lock);
+}
+
+extern "C" int pthread_rwlock_wrlock(pthread_rwlock_t *lock) __THROWNL
+{
+    check("pthread_rwlock_wrlock");
+    return nextWriteLock.get()(lock);
+}
+
+extern "C" int pthread_cond_wait(pthread_cond_t *condition, pthread_mutex_t *mutex)
+{
+    check("pthread_cond_wait");
+    return nextConditionWait.get()(condition, mutex);
+}
+
+extern "C" int pthread_cond_timedwait(pthread_cond_t *condition, pthread_mutex_t *mutex, const struct timespec *time)
+{
+    check("pthread_cond_timedwait");
+    return nextConditionTimedWait.get()(condition, mutex, time);
+}
+
+extern "C" int sem_wait(sem_t *semaphore)
+{
+    check("sem_wait");
+    return nextSemaphoreWait.get()(semaphore);
+}
+
+//==============================================================================
+// Appels système bloquants
+extern "C" int open(const char *path, int flags, ...)
+{
+    check("open");
+
+    va_list arguments;
+    va_start(arguments, flags);
+    auto mode = (flags & (O_CREAT | O_TMPFILE)) != 0 ? va_arg(arguments, mode_t) : (mode_t) 0;
+    va_end(arguments);
+
+    return nextOpen.get()(path, flags, mode);
+}
+
+extern "C" FILE *fopen(const char *path, const char *mode)
+{
+    check("fopen");
+    return nextFileOpen.get()(path, mode);
+}
+
+extern "C" ssize_t read(int file, void *buffer, size_t size)
+{
+    check("read");
+    return nextRead.get()(file, buffer, size);
+}
+
+extern "C" ssize_t write(int file, const void *buffer, size_t size)
+{
+    check("write");
+    return nextWrite.get()(file, buffer, size);
+}
+
+extern "C" int nanosleep(const struct timespec *duration, struct timespec *remaining)
+{
+    check("nanosleep");
+    return nextSleep.get()(duration, remaining);
+}
+
+extern "C" int usleep(useconds_t microseconds)
+{
+    check("usleep");
+    return nextMicrosecondSleep.get()(microseconds);
+}
+
+extern "C" int sched_yield() __THROW
+{
+    check("sched_yield");
+    return nextYield.get()();
+}
+
+extern "C" void *mmap(void *address, size_t length, int protection, int flags, int file, off_t offset) __THROW
+{
+    check("mmap");
+    return nextMap.get()(address, length, protection, flags, file, offset);
+}
+
+#endif
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+// 1 pour instrumenter le thread audio pendant processBlock (Linux, glibc) : option CMake SDPEQ_REALTIME_GUARD
+#ifndef SDPEQ_REALTIME_GUARD
+ #define SDPEQ_REALTIME_GUARD 0
+#endif
+
+//==============================================================================
+/**
+    Garde temps réel, pour les builds de debug et la CI.
+
+    Pendant processBlock, le thread est marqué par un drapeau thread_local. Les fonctions
+    de la libc qui n'ont rien à faire sur le thread audio sont remplacées dans l'exécutable
+    (interposition des symboles, sans outil externe) : allocations (malloc, free, et donc
+    operator new et delete de la bibliothèque standard), verrous qui peuvent attendre
+    (pthread_mutex_lock, rwlock, variables de condition, sémaphores) et appels système
+    bloquants (fichiers, attente, sched_yield, mmap). Hors du drapeau, elles appellent
+    simplement celles de la libc.
+
+    Une violation écrit la fonction et la pile d'appel sur stderr, puis arrête le
+    programme ; avec la variable d'environnement SDPEQ_REALTIME_GUARD=report, le
+    programme continue et les violations sont seulement comptées.
+
+    L'interposition ne marche que dans un exécutable (banc de mesure, rendu hors ligne,
+    Standalone) : dans le plugin VST3 chargé par un hôte, ce sont les fonctions de la libc
+    qui restent utilisées. Sans l'option, ScopedAudioCallback est vide.
+*/
+namespace EqRealtimeGuard
+{
+#if SDPEQ_REALTIME_GUARD
+    // Marque le thread courant comme thread audio pour la durée de l'objet
+    class ScopedAudioCallback
+    {
+    public:
+        ScopedAudioCallback() noexcept;
+
+        ~ScopedAudioCallback() noexcept;
+
+    private:
+        bool wasInAudioCallback;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedAudioCallback)
+    };
+
+    // Violations relevées depuis le lancement (seulement en mode report : sinon la première arrête tout)
+    juce::int64 getNumViolations() noexcept;
+#else
+    class ScopedAudioCallback
+    {
+    public:
+        ScopedAudioCallback() noexcept {}
+    };
+
+    inline juce::int64 getNumViolations() noexcept { return 0; }
+#endif
+}
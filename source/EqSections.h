@@ -0,0 +1,152 @@
+#pragma once
+
+#include "EqFilterDesign.h"
+
+//==============================================================================
+/*  Noyaux par échantillon des deux structures de cellule du second ordre.
+
+    Les deux ont deux variables d'état ; NumericType est la précision des
+    coefficients (float ou double) et SampleType peut être un type SIMD du
+    même type d'élément, pour traiter plusieurs canaux à la fois.
+*/
+enum class SectionTopology
+{
+    biquad,
+    svf
+};
+
+/*  Canaux traités par une bande, pris par paires (gauche, droite) : les voies 2k et 2k + 1
+    d'un registre, jamais à cheval sur deux groupes puisque le nombre de voies est pair.
+    Milieu et côté sont (G + D) / 2 et (G - D) / 2 ; la bande n'y ajoute que sa contribution,
+    ce qui revient à coder, filtrer et décoder dans la même passe.
+
+    Seules les vraies paires gauche / droite de la disposition des canaux sont concernées
+    (EqEngine::isStereoPair()) : centre et LFE d'un 5.1, dernier canal d'une disposition
+    impaire ou canaux discrets restent traités en stéréo quel que soit le routage.
+*/
+enum class ChannelRouting
+{
+    stereo,
+    left,
+    right,
+    mid,
+    side
+};
+
+// Echange les voies 2k et 2k + 1 (gauche et droite de chaque paire de canaux)
+template <typename NumericType>
+juce::dsp::SIMDRegister<NumericType> swapChannelPairs(juce::dsp::SIMDRegister<NumericType> x) noexcept
+{
+    using Register = juce::dsp::SIMDRegister<NumericType>;
+
+    // Types natifs de SIMDRegister : __m256 / __m256d en AVX2, __m128 / __m128d en SSE2, float32x4_t
+    // en NEON (les doubles NEON de JUCE ne sont pas natifs et passent par la boucle)
+   #if defined(__AVX2__)
+    if constexpr (std::is_same_v<NumericType, float>)
+        return Register::fromNative(_mm256_permute_ps(x.value, 0xb1));
+    else if constexpr (std::is_same_v<NumericType, double>)
+        return Register::fromNative(_mm256_permute_pd(x.value, 0x5));
+    else
+   #elif defined(__SSE2__)
+    if constexpr (std::is_same_v<NumericType, float>)
+        return Register::fromNative(_mm_shuffle_ps(x.value, x.value, 0xb1));
+    else if constexpr (std::is_same_v<NumericType, double>)
+        return Register::fromNative(_mm_shuffle_pd(x.value, x.value, 1));
+    else
+   #elif JUCE_USE_SIMD && (defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(__aarch64__))
+    if constexpr (std::is_same_v<NumericType, float>)
+        return Register::fromNative(vrev64q_f32(x.value));
+    else
+   #endif
+    {
+        for (size_t i = 0; i + 1 < Register::size(); i += 2)
+        {
+            auto left = x.get(i);
+            x.set(i, x.get(i + 1));
+            x.set(i + 1, left);
+        }
+
+        return x;
+    }
+}
+
+// Voies concernées par un routage : 1 pour les canaux traités, 0 pour les autres (milieu et côté touchent les deux)
+template <typename NumericType>
+juce::dsp::SIMDRegister<NumericType> getRoutingMask(ChannelRouting routing) noexcept
+{
+    auto mask = juce::dsp::SIMDRegister<NumericType>::expand((NumericType) 1);
+
+    for (size_t i = 0; i < mask.size(); ++i)
+        if ((routing == ChannelRouting::left && i % 2 == 1) || (routing == ChannelRouting::right && i % 2 == 0))
+            mask.set(i, (NumericType) 0);
+
+    return mask;
+}
+
+// Même chose quand seules certaines voies forment une vraie paire : pairs vaut 1 dans ces voies et 0
+// ailleurs, où la cellule agit comme en stéréo
+template <typename NumericType>
+juce::dsp::SIMDRegister<NumericType> getRoutingMask(ChannelRouting routing, juce::dsp::SIMDRegister<NumericType> pairs) noexcept
+{
+    auto one = juce::dsp::SIMDRegister<NumericType>::expand((NumericType) 1);
+    return getRoutingMask<NumericType>(routing) * pairs + (one - pairs);
+}
+
+template <typename SampleType>
+struct SectionState
+{
+    SampleType s1 {};
+    SampleType s2 {};
+};
+
+template <typename NumericType>
+struct BiquadSection
+{
+    using Coefficients = BiquadCoefficients<NumericType>;
+
+    // Forme directe II transposée
+    template <typename SampleType>
+    static SampleType processSample(const Coefficients &c, SectionState<SampleType> &state, SampleType x) noexcept
+    {
+        auto y = x * c.b0 + state.s1;
+        state.s1 = x * c.b1 - y * c.a1 + state.s2;
+        state.s2 = x * c.b2 - y * c.a2;
+        return y;
+    }
+
+    // Etat du régime permanent pour une entrée constante x : y = H(1) x
+    template <typename SampleType>
+    static void prime(const Coefficients &c, SectionState<SampleType> &state, SampleType x) noexcept
+    {
+        auto dcGain = (c.b0 + c.b1 + c.b2) / ((NumericType) 1 + c.a1 + c.a2);
+        auto y = x * dcGain;
+        state.s2 = x * c.b2 - y * c.a2;
+        state.s1 = x * c.b1 - y * c.a1 + state.s2;
+    }
+};
+
+template <typename NumericType>
+struct SvfSection
+{
+    using Coefficients = SvfCoefficients<NumericType>;
+
+    // s1 et s2 sont les états des deux intégrateurs trapèzes (ic1eq et ic2eq)
+    template <typename SampleType>
+    static SampleType processSample(const Coefficients &c, SectionState<SampleType> &state, SampleType x) noexcept
+    {
+        auto v3 = x - state.s2;
+        auto v1 = state.s1 * c.a1 + v3 * c.a2;
+        auto v2 = state.s2 + state.s1 * c.a2 + v3 * c.a3;
+        state.s1 = v1 + v1 - state.s1;
+        state.s2 = v2 + v2 - state.s2;
+        return x * c.m0 + v1 * c.m1 + v2 * c.m2;
+    }
+
+    // Etat du régime permanent pour une entrée constante x : passe-bande nul, passe-bas égal à x
+    template <typename SampleType>
+    static void prime(const Coefficients &, SectionState<SampleType> &state, SampleType x) noexcept
+    {
+        state.s1 = x - x;
+        state.s2 = x;
+    }
+};
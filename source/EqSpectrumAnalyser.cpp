@@ -0,0 +1,223 @@
+#include "EqSpectrumAnalyser.h"
+
+namespace
+{
+    // Constantes de temps du lissage des niveaux affichés
+    constexpr double attackSeconds = 0.01;
+    constexpr double releaseSeconds = 0.3;
+}
+
+//==============================================================================
+EqSpectrumAnalyser::Tap::Tap()
+    : fifo(fifoSize), buffer((size_t) fifoSize), history((size_t) fftSize)
+{
+    levels.fill(floorDecibels);
+}
+
+EqSpectrumAnalyser::EqSpectrumAnalyser()
+    : juce::Thread("EQ spectrum analyser"), fftData((size_t) fftSize * 2)
+{
+    for (auto &frame : frames)
+    {
+        frame.pre.fill(floorDecibels);
+        frame.post.fill(floorDecibels);
+    }
+
+    prepare(sampleRate);
+}
+
+EqSpectrumAnalyser::~EqSpectrumAnalyser()
+{
+    stopThread(1000);
+}
+
+void EqSpectrumAnalyser::prepare(double newSampleRate)
+{
+    auto wasRunning = isThreadRunning();
+    stopThread(1000);
+
+    sampleRate = newSampleRate;
+    auto binWidth = sampleRate / fftSize;
+    auto highestBin = fftSize / 2;
+    auto halfStep = std::pow((double) maximumFrequency / minimumFrequency, 0.5 / (numPoints - 1));
+
+    // Chaque point couvre les bins entre les moyennes géométriques avec ses voisins ; en bas du
+    // spectre, où un point tombe entre deux bins, le module est interpolé
+    for (int point = 0; point < numPoints; ++point)
+    {
+        auto frequency = (double) getFrequency(point);
+        auto first = (int) std::ceil(frequency / halfStep / binWidth);
+        auto last = juce::jmin(highestBin, (int) std::floor(frequency * halfStep / binWidth));
+
+        firstBin[(size_t) point] = first;
+        lastBin[(size_t) point] = last;
+        binPosition[(size_t) point] = (float) juce::jmin((double) highestBin, frequency / binWidth);
+    }
+
+    auto hopSeconds = hopSize / sampleRate;
+    attack = (float) (1.0 - std::exp(-hopSeconds / attackSeconds));
+    release = (float) (1.0 - std::exp(-hopSeconds / releaseSeconds));
+
+    if (wasRunning)
+        startThread();
+}
+
+void EqSpectrumAnalyser::setActive(bool shouldBeActive)
+{
+    if (shouldBeActive == isActive())
+        return;
+
+    active.store(shouldBeActive, std::memory_order_relaxed);
+
+    if (shouldBeActive)
+        startThread();
+    else
+        stopThread(1000);
+}
+
+float EqSpectrumAnalyser::getFrequency(int point) noexcept
+{
+    return minimumFrequency * std::pow(maximumFrequency / minimumFrequency, (float) point / (float) (numPoints - 1));
+}
+
+//==============================================================================
+template <typename SampleType>
+void EqSpectrumAnalyser::push(const juce::dsp::AudioBlock<SampleType> &block, Tap &tap) noexcept
+{
+    if (! active.load(std::memory_order_relaxed) || block.getNumChannels() == 0)
+        return;
+
+    // File pleine (thread de fond en retard) : le reste du bloc est perdu pour l'analyse
+    const auto scope = tap.fifo.write((int) block.getNumSamples());
+    auto gain = (float) (1.0 / (double) block.getNumChannels());
+
+    // Mélange mono : premier canal recopié, les autres ajoutés
+    auto mix = [&](int destination, size_t offset, int count)
+    {
+        auto *output = tap.buffer.data() + destination;
+        auto *first = block.getChannelPointer(0) + offset;
+
+        for (int i = 0; i < count; ++i)
+            output[i] = (float) first[i] * gain;
+
+        for (size_t channel = 1; channel < block.getNumChannels(); ++channel)
+        {
+            auto *input = block.getChannelPointer(channel) + offset;
+
+            for (int i = 0; i < count; ++i)
+                output[i] += (float) input[i] * gain;
+        }
+    };
+
+    mix(scope.startIndex1, 0, scope.blockSize1);
+    mix(scope.startIndex2, (size_t) scope.blockSize1, scope.blockSize2);
+}
+
+//==============================================================================
+void EqSpectrumAnalyser::run()
+{
+    // Ce qui est resté dans les files pendant que l'analyseur était arrêté est périmé
+    for (auto *tap : { &pre, &post })
+    {
+        const auto scope = tap->fifo.read(tap->fifo.getNumReady());
+        tap->numNewSamples = 0;
+    }
+
+    while (! threadShouldExit())
+    {
+        auto preReady = readTap(pre);
+        auto postReady = readTap(post);
+
+        if (preReady)
+            analyse(pre, frames[(size_t) backIndex].pre);
+
+        if (postReady)
+            analyse(post, frames[(size_t) backIndex].post);
+
+        if (preReady || postReady)
+        {
+            publish();
+            continue;
+        }
+
+        wait(5);
+    }
+}
+
+bool EqSpectrumAnalyser::readTap(Tap &tap) noexcept
+{
+    // Pas plus que ce qui manque pour la prochaine image : le reste attend le tour suivant
+    auto numToRead = juce::jmin(tap.fifo.getNumReady(), hopSize - tap.numNewSamples);
+    const auto scope = tap.fifo.read(numToRead);
+
+    // La fenêtre glisse : les nouveaux échantillons entrent par la fin de l'historique
+    auto append = [&](int start, int count)
+    {
+        if (count <= 0)
+            return;
+
+        std::move(tap.history.begin() + count, tap.history.end(), tap.history.begin());
+        std::copy_n(tap.buffer.begin() + start, count, tap.history.end() - count);
+    };
+
+    append(scope.startIndex1, scope.blockSize1);
+    append(scope.startIndex2, scope.blockSize2);
+    tap.numNewSamples += scope.blockSize1 + scope.blockSize2;
+
+    if (tap.numNewSamples < hopSize)
+        return false;
+
+    tap.numNewSamples = 0;
+    return true;
+}
+
+void EqSpectrumAnalyser::analyse(Tap &tap, std::array<float, numPoints> &output) noexcept
+{
+    std::copy(tap.history.begin(), tap.history.end(), fftData.begin());
+    window.multiplyWithWindowingTable(fftData.data(), (size_t) fftSize);
+    fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+    // Une sinusoïde pleine échelle donne 0 dB : spectre unilatéral (x 2), gain cohérent de la fenêtre de Hann (0,5)
+    auto scale = 4.0f / (float) fftSize;
+
+    for (size_t point = 0; point < (size_t) numPoints; ++point)
+    {
+        float magnitude;
+
+        if (lastBin[point] >= firstBin[point])
+        {
+            magnitude = *std::max_element(fftData.begin() + firstBin[point], fftData.begin() + lastBin[point] + 1);
+        }
+        else
+        {
+            auto bin = (int) binPosition[point];
+            auto fraction = binPosition[point] - (float) bin;
+            magnitude = juce::jmap(fraction, fftData[(size_t) bin], fftData[(size_t) bin + 1]);
+        }
+
+        auto decibels = juce::Decibels::gainToDecibels(magnitude * scale, floorDecibels);
+        auto &level = tap.levels[point];
+        level += (decibels - level) * (decibels > level ? attack : release);
+        output[point] = level;
+    }
+}
+
+// Le tampon écrit devient celui du milieu, marqué comme nouveau ; l'ancien tampon du milieu sert à l'image suivante
+void EqSpectrumAnalyser::publish() noexcept
+{
+    frames[(size_t) backIndex].pre = pre.levels;
+    frames[(size_t) backIndex].post = post.levels;
+    backIndex = middle.exchange(backIndex | freshFlag, std::memory_order_acq_rel) & ~freshFlag;
+}
+
+bool EqSpectrumAnalyser::pullFrame() noexcept
+{
+    if ((middle.load(std::memory_order_acquire) & freshFlag) == 0)
+        return false;
+
+    frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & ~freshFlag;
+    return true;
+}
+
+template void EqSpectrumAnalyser::push(const juce::dsp::AudioBlock<float> &, Tap &) noexcept;
+template void EqSpectrumAnalyser::push(const juce::dsp::AudioBlock<double> &, Tap &) noexcept;
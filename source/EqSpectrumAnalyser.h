@@ -0,0 +1,123 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+/**
+    Analyseur de spectre avant et après l'EQ, pour l'interface.
+
+    Le thread audio ne fait que recopier le mélange mono de chaque bloc dans une file
+    circulaire sans verrou (AbstractFifo, un producteur et un consommateur) par point de
+    mesure ; si la file est pleine, les échantillons en trop sont perdus. Un thread de
+    fond vide les files, calcule une FFT fenêtrée (Hann) tous les hopSize échantillons,
+    regroupe les bins sur numPoints fréquences logarithmiques entre 20 Hz et 20 kHz et
+    lisse les niveaux dans le temps (montée rapide, retombée lente). Les résultats sont
+    publiés par triple tampon : l'interface lit toujours la dernière image complète,
+    sans verrou et sans jamais bloquer le thread de fond.
+
+    L'analyseur ne tourne que lorsqu'il est actif (setActive(), appelé par l'interface) :
+    sinon le thread de fond est arrêté et le thread audio ne fait qu'un test par bloc.
+*/
+class EqSpectrumAnalyser : private juce::Thread
+{
+public:
+    static constexpr int fftOrder = 12;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int hopSize = fftSize / 4;
+
+    static constexpr int numPoints = 256;
+    static constexpr float minimumFrequency = 20.0f;
+    static constexpr float maximumFrequency = 20000.0f;
+
+    // Plancher des niveaux publiés, en dB relatifs à une sinusoïde pleine échelle
+    static constexpr float floorDecibels = -100.0f;
+
+    // Une image publiée : niveaux en dB aux numPoints fréquences de getFrequency()
+    struct Frame
+    {
+        std::array<float, numPoints> pre, post;
+    };
+
+    EqSpectrumAnalyser();
+
+    ~EqSpectrumAnalyser() override;
+
+    // Thread de messages
+    void prepare(double sampleRate);
+
+    // Thread de messages : démarre ou arrête complètement l'analyse
+    void setActive(bool shouldBeActive);
+
+    double getSampleRate() const noexcept { return sampleRate; }
+
+    bool isActive() const noexcept { return active.load(std::memory_order_relaxed); }
+
+    // Thread audio : signal avant et après l'EQ ; ne fait rien si l'analyseur est inactif
+    template <typename SampleType>
+    void pushPre(const juce::dsp::AudioBlock<SampleType> &block) noexcept { push(block, pre); }
+
+    template <typename SampleType>
+    void pushPost(const juce::dsp::AudioBlock<SampleType> &block) noexcept { push(block, post); }
+
+    // Thread de l'interface : récupère la dernière image publiée ; renvoie false s'il n'y en a pas de nouvelle
+    bool pullFrame() noexcept;
+
+    // Thread de l'interface : l'image récupérée par le dernier pullFrame()
+    const Frame &getFrame() const noexcept { return frames[(size_t) frontIndex]; }
+
+    static float getFrequency(int point) noexcept;
+
+private:
+    // File d'un point de mesure et état du calcul de son spectre (propre au thread de fond)
+    struct Tap
+    {
+        Tap();
+
+        juce::AbstractFifo fifo;
+        std::vector<float> buffer;
+
+        std::vector<float> history;
+        int numNewSamples = 0;
+        std::array<float, numPoints> levels;
+    };
+
+    template <typename SampleType>
+    void push(const juce::dsp::AudioBlock<SampleType> &block, Tap &tap) noexcept;
+
+    void run() override;
+
+    // Lit ce qui est prêt dans la file ; renvoie true quand hopSize nouveaux échantillons sont arrivés
+    bool readTap(Tap &tap) noexcept;
+
+    void analyse(Tap &tap, std::array<float, numPoints> &output) noexcept;
+
+    void publish() noexcept;
+
+    static constexpr int fifoSize = 32768;
+
+    std::atomic<bool> active { false };
+    double sampleRate = 44100.0;
+
+    Tap pre, post;
+
+    juce::dsp::FFT fft { fftOrder };
+    juce::dsp::WindowingFunction<float> window { (size_t) fftSize, juce::dsp::WindowingFunction<float>::hann, false };
+    std::vector<float> fftData;
+
+    // Bins couverts par chaque point : [firstBin, lastBin], ou position interpolée quand le point tombe entre deux bins
+    std::array<int, numPoints> firstBin {}, lastBin {};
+    std::array<float, numPoints> binPosition {};
+
+    float attack = 1.0f, release = 0.1f;
+
+    // Triple tampon : backIndex appartient au thread de fond, frontIndex à l'interface,
+    // middle contient l'index du troisième, plus freshFlag s'il n'a pas encore été lu
+    static constexpr int freshFlag = 4;
+    std::array<Frame, 3> frames;
+    int backIndex = 0;
+    int frontIndex = 1;
+    std::atomic<int> middle { 2 };
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EqSpectrumAnalyser)
+};
@@ -0,0 +1,180 @@
+#include "EqSpectrumDisplay.h"
+#include "EqFilterDesign.h"
+
+//==============================================================================
+EqSpectrumDisplay::EqSpectrumDisplay(EqSpectrumAnalyser &analyserToUse, EqParameters &eqParametersToUse)
+    : analyser(analyserToUse), eqParameters(eqParametersToUse),
+      responseSinSquared((size_t) numResponsePoints), responseMagnitudeSquared((size_t) numResponsePoints)
+{
+    setOpaque(true);
+    analyser.setActive(true);
+    startTimerHz(frameRate);
+}
+
+EqSpectrumDisplay::~EqSpectrumDisplay()
+{
+    stopTimer();
+    analyser.setActive(false);
+}
+
+void EqSpectrumDisplay::timerCallback()
+{
+    auto newFrame = analyser.pullFrame();
+
+    if (updateResponse())
+    {
+        renderResponseLayer();
+        newFrame = true;
+    }
+
+    if (newFrame)
+        repaint();
+}
+
+void EqSpectrumDisplay::resized()
+{
+    updateResponse();
+    renderResponseLayer();
+}
+
+bool EqSpectrumDisplay::updateResponse()
+{
+    // Fréquence à laquelle tournent les filtres : celle de l'hôte, suréchantillonnée en phase minimale. Elle
+    // porte le facteur de suréchantillonnage : changer d'ordre ou de mode de phase suffit à recalculer la réponse
+    auto oversamplingOrder = eqParameters.isLinearPhase() ? 0 : eqParameters.getOversamplingOrder();
+    auto sampleRate = analyser.getSampleRate() * (double) (1 << oversamplingOrder);
+    auto changed = sampleRate != responseSampleRate;
+
+    // Compteurs relevés avant les valeurs, comme EqLinearPhase : un changement pendant le calcul sera vu au tour suivant
+    for (int i = 0; i < EqParameters::numBands; ++i)
+    {
+        auto generation = eqParameters.getBand(i).generation.load(std::memory_order_acquire);
+        changed = changed || generation != responseGenerations[(size_t) i];
+        responseGenerations[(size_t) i] = generation;
+    }
+
+    if (! changed)
+        return false;
+
+    if (sampleRate != responseSampleRate)
+    {
+        auto minimum = (double) EqSpectrumAnalyser::minimumFrequency;
+        auto ratio = (double) EqSpectrumAnalyser::maximumFrequency / minimum;
+
+        // Au-delà de Nyquist la réponse n'a pas de sens : le point est ramené à Nyquist
+        for (size_t point = 0; point < (size_t) numResponsePoints; ++point)
+        {
+            auto frequency = juce::jmin(sampleRate / 2.0, minimum * std::pow(ratio, (double) point / (numResponsePoints - 1)));
+            responseSinSquared[point] = juce::square(std::sin(juce::MathConstants<double>::pi * frequency / sampleRate));
+        }
+
+        responseSampleRate = sampleRate;
+    }
+
+    std::fill(responseMagnitudeSquared.begin(), responseMagnitudeSquared.end(), 1.0);
+
+    for (int i = 0; i < EqParameters::numBands; ++i)
+    {
+        auto &band = eqParameters.getBand(i);
+
+        if (band.on->load() < 0.5f)
+            continue;
+
+        auto type = (FilterType) juce::jlimit(0, (int) EqFilterDesign::lastFilterType, juce::roundToInt(band.type->load()));
+        EqFilterDesign::multiplyMagnitudeSquared(type, sampleRate, band.freq->load(), band.q->load(), band.gain->load(),
+                                                 responseSinSquared.data(), responseMagnitudeSquared.data(),
+                                                 responseMagnitudeSquared.size());
+    }
+
+    return true;
+}
+
+// Le tracé du chemin, coûteux avec le rendu logiciel, n'est refait qu'ici ; paint() recopie l'image
+void EqSpectrumDisplay::renderResponseLayer()
+{
+    if (getWidth() <= 0 || getHeight() <= 0)
+        return;
+
+    if (responseLayer.getWidth() != getWidth() || responseLayer.getHeight() != getHeight())
+        responseLayer = juce::Image(juce::Image::ARGB, getWidth(), getHeight(), true);
+    else
+        responseLayer.clear(responseLayer.getBounds());
+
+    auto height = (float) getHeight();
+    auto xScale = (float) getWidth() / (float) (numResponsePoints - 1);
+
+    auto getY = [&](double magnitudeSquared)
+    {
+        auto decibels = 10.0f * (float) std::log10(juce::jmax(1.0e-12, magnitudeSquared));
+        return juce::jmap(juce::jlimit(-responseRangeDecibels, responseRangeDecibels, decibels),
+                          responseRangeDecibels, -responseRangeDecibels, 0.0f, height);
+    };
+
+    juce::Path path;
+    path.preallocateSpace(numResponsePoints * 3);
+    path.startNewSubPath(0.0f, getY(responseMagnitudeSquared[0]));
+
+    for (size_t point = 1; point < (size_t) numResponsePoints; ++point)
+        path.lineTo((float) point * xScale, getY(responseMagnitudeSquared[point]));
+
+    juce::Graphics g(responseLayer);
+    g.setColour(juce::Colours::white.withAlpha(0.25f));
+    g.drawHorizontalLine(juce::roundToInt(height / 2.0f), 0.0f, (float) getWidth());
+    g.setColour(juce::Colours::cyan);
+    g.strokePath(path, juce::PathStrokeType(2.0f));
+}
+
+//==============================================================================
+void EqSpectrumDisplay::paint(juce::Graphics &g)
+{
+    g.fillAll(juce::Colours::black);
+
+    // Grille : décades en fréquence, tous les 10 dB en niveau
+    g.setColour(juce::Colours::white.withAlpha(0.12f));
+
+    for (auto frequency : { 50.0f, 100.0f, 200.0f, 500.0f, 1000.0f, 2000.0f, 5000.0f, 10000.0f })
+        g.drawVerticalLine(juce::roundToInt(getXForFrequency(frequency)), 0.0f, (float) getHeight());
+
+    for (auto decibels = maximumDecibels - 10.0f; decibels > minimumDecibels; decibels -= 10.0f)
+        g.drawHorizontalLine(juce::roundToInt(getYForDecibels(decibels)), 0.0f, (float) getWidth());
+
+    auto &frame = analyser.getFrame();
+
+    auto prePath = createPath(frame.pre);
+    prePath.lineTo((float) getWidth(), (float) getHeight());
+    prePath.lineTo(0.0f, (float) getHeight());
+    prePath.closeSubPath();
+    g.setColour(juce::Colours::grey.withAlpha(0.5f));
+    g.fillPath(prePath);
+
+    g.setColour(juce::Colours::orange);
+    g.strokePath(createPath(frame.post), juce::PathStrokeType(1.5f));
+
+    g.drawImageAt(responseLayer, 0, 0);
+}
+
+juce::Path EqSpectrumDisplay::createPath(const std::array<float, EqSpectrumAnalyser::numPoints> &levels) const
+{
+    juce::Path path;
+    path.preallocateSpace(EqSpectrumAnalyser::numPoints * 3 + 12);
+    path.startNewSubPath(0.0f, getYForDecibels(levels[0]));
+
+    for (int point = 1; point < EqSpectrumAnalyser::numPoints; ++point)
+        path.lineTo(getXForFrequency(EqSpectrumAnalyser::getFrequency(point)), getYForDecibels(levels[(size_t) point]));
+
+    return path;
+}
+
+float EqSpectrumDisplay::getXForFrequency(float frequency) const noexcept
+{
+    auto proportion = std::log(frequency / EqSpectrumAnalyser::minimumFrequency)
+                    / std::log(EqSpectrumAnalyser::maximumFrequency / EqSpectrumAnalyser::minimumFrequency);
+
+    return proportion * (float) getWidth();
+}
+
+float EqSpectrumDisplay::getYForDecibels(float decibels) const noexcept
+{
+    return juce::jmap(juce::jlimit(minimumDecibels, maximumDecibels, decibels), maximumDecibels, minimumDecibels,
+                      0.0f, (float) getHeight());
+}
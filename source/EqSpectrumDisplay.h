@@ -0,0 +1,74 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "EqParameters.h"
+#include "EqSpectrumAnalyser.h"
+
+//==============================================================================
+/**
+    Affichage du spectre avant l'EQ (surface) et après l'EQ (courbe), de 20 Hz à 20 kHz
+    en abscisse logarithmique, et de la réponse en amplitude de l'ensemble des bandes.
+
+    Active l'analyseur tant que le composant existe : fermer l'interface arrête le
+    thread de fond. L'image est relue à frameRate Hz et redessinée seulement si une
+    nouvelle a été publiée.
+
+    La réponse n'est recalculée que lorsque le compteur de génération d'une bande ou la
+    fréquence des filtres (hôte et suréchantillonnage) a changé (au plus une fois par
+    période du timer, même pendant le déplacement d'un bouton), sur numResponsePoints
+    fréquences, par EqFilterDesign::multiplyMagnitudeSquared(), avec les coefficients
+    que le moteur utilise à cette fréquence.
+    Sa courbe est dessinée une fois dans une image, que paint() se contente de recopier.
+*/
+class EqSpectrumDisplay : public juce::Component,
+                          private juce::Timer
+{
+public:
+    EqSpectrumDisplay(EqSpectrumAnalyser &analyser, EqParameters &eqParameters);
+
+    ~EqSpectrumDisplay() override;
+
+    void paint(juce::Graphics &g) override;
+
+    void resized() override;
+
+private:
+    void timerCallback() override;
+
+    // Recalcule la réponse si une bande, la fréquence de l'hôte ou le suréchantillonnage a changé ; renvoie true dans ce cas
+    bool updateResponse();
+
+    void renderResponseLayer();
+
+    juce::Path createPath(const std::array<float, EqSpectrumAnalyser::numPoints> &levels) const;
+
+    float getXForFrequency(float frequency) const noexcept;
+
+    float getYForDecibels(float decibels) const noexcept;
+
+    static constexpr int frameRate = 30;
+
+    // Plage verticale affichée
+    static constexpr float minimumDecibels = -90.0f;
+    static constexpr float maximumDecibels = 0.0f;
+
+    // Plage verticale de la réponse des bandes, centrée sur 0 dB
+    static constexpr float responseRangeDecibels = 24.0f;
+
+    static constexpr int numResponsePoints = 1024;
+
+    EqSpectrumAnalyser &analyser;
+    EqParameters &eqParameters;
+
+    // Réponse aux fréquences de getFrequency() étalées sur numResponsePoints points, et ce qui a servi à la calculer
+    std::vector<double> responseSinSquared, responseMagnitudeSquared;
+    std::array<juce::uint32, EqParameters::numBands> responseGenerations {};
+
+    // Fréquence des filtres, suréchantillonnage compris
+    double responseSampleRate = 0.0;
+
+    juce::Image responseLayer;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EqSpectrumDisplay)
+};
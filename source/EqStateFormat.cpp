@@ -0,0 +1,226 @@
+#include "EqStateFormat.h"
+
+namespace
+{
+    // En-tête : magic, version, version minimale du lecteur, taille totale ; puis chaque section : étiquette et taille
+    constexpr size_t headerSize = 12;
+    constexpr size_t sectionHeaderSize = 6;
+    constexpr size_t parameterSize = 8;
+
+    // Version minimale d'un lecteur pour les blocs écrits ici
+    constexpr int minimumReaderVersion = 1;
+
+    juce::uint16 readShort(const char *data) noexcept
+    {
+        return juce::ByteOrder::littleEndianShort(data);
+    }
+
+    juce::uint32 readInt(const char *data) noexcept
+    {
+        return juce::ByteOrder::littleEndianInt(data);
+    }
+
+    float readFloat(const char *data) noexcept
+    {
+        auto bits = readInt(data);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // Écriture en little-endian ; renvoient la position suivante
+    char *writeShort(char *data, juce::uint16 value) noexcept
+    {
+        value = juce::ByteOrder::swapIfBigEndian(value);
+        std::memcpy(data, &value, sizeof(value));
+        return data + sizeof(value);
+    }
+
+    char *writeInt(char *data, juce::uint32 value) noexcept
+    {
+        value = juce::ByteOrder::swapIfBigEndian(value);
+        std::memcpy(data, &value, sizeof(value));
+        return data + sizeof(value);
+    }
+
+    char *writeFloat(char *data, float value) noexcept
+    {
+        juce::uint32 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return writeInt(data, bits);
+    }
+}
+
+//==============================================================================
+EqStateFormat::EqStateFormat(juce::AudioProcessorValueTreeState &stateToUse)
+    : state(stateToUse)
+{
+    for (auto *processorParameter : state.processor.getParameters())
+    {
+        if (auto *parameter = dynamic_cast<juce::RangedAudioParameter *>(processorParameter))
+            entries.push_back({ getParameterKey(parameter->paramID), parameter, state.getRawParameterValue(parameter->paramID) });
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.key < b.key; });
+
+    // Deux identifiants de même empreinte rendraient l'état ambigu : à corriger en renommant l'un d'eux
+    jassert(std::adjacent_find(entries.begin(), entries.end(),
+                               [](const Entry &a, const Entry &b) { return a.key == b.key; }) == entries.end());
+}
+
+juce::uint32 EqStateFormat::getParameterKey(const juce::String &parameterID) noexcept
+{
+    juce::uint32 hash = 2166136261u;
+
+    for (auto *c = parameterID.toRawUTF8(); *c != 0; ++c)
+        hash = (hash ^ (juce::uint8) *c) * 16777619u;
+
+    return hash;
+}
+
+bool EqStateFormat::isBinaryState(const void *data, int sizeInBytes) noexcept
+{
+    return data != nullptr && sizeInBytes >= (int) headerSize && readInt(static_cast<const char *>(data)) == magic;
+}
+
+//==============================================================================
+void EqStateFormat::write(juce::MemoryBlock &destData) const
+{
+    auto &tree = state.state;
+    auto numProperties = tree.getNumProperties();
+    auto parametersSize = 2 + entries.size() * parameterSize;
+    auto fixedSize = headerSize + sectionHeaderSize + parametersSize + sectionHeaderSize + 2;
+
+    // Partie de taille fixe écrite directement dans le bloc : MemoryOutputStream coûte un appel virtuel par valeur
+    destData.setSize(fixedSize, false);
+    auto *position = static_cast<char *>(destData.getData());
+
+    position = writeInt(position, magic);
+    position = writeShort(position, (juce::uint16) version);
+    position = writeShort(position, (juce::uint16) minimumReaderVersion);
+    position = writeInt(position, 0);
+
+    position = writeShort(position, (juce::uint16) Section::parameters);
+    position = writeInt(position, (juce::uint32) parametersSize);
+    position = writeShort(position, (juce::uint16) entries.size());
+
+    for (auto &entry : entries)
+    {
+        position = writeInt(position, entry.key);
+        position = writeFloat(position, entry.value->load());
+    }
+
+    position = writeShort(position, (juce::uint16) Section::properties);
+    position = writeInt(position, 0);
+    writeShort(position, (juce::uint16) numProperties);
+
+    if (numProperties > 0)
+    {
+        juce::MemoryOutputStream output(destData, true);
+
+        for (int i = 0; i < numProperties; ++i)
+        {
+            auto name = tree.getPropertyName(i);
+            output.writeString(name.toString());
+            tree.getProperty(name).writeToStream(output);
+        }
+    }
+
+    // Tailles connues une fois les propriétés écrites
+    auto *data = static_cast<char *>(destData.getData());
+    writeInt(data + fixedSize - 6, (juce::uint32) (destData.getSize() - fixedSize + 2));
+    writeInt(data + 8, (juce::uint32) destData.getSize());
+}
+
+bool EqStateFormat::read(const void *data, int sizeInBytes)
+{
+    if (! isBinaryState(data, sizeInBytes))
+        return false;
+
+    auto *bytes = static_cast<const char *>(data);
+    auto size = (size_t) readInt(bytes + 8);
+
+    // Écrit par une version du format qui ne se relit plus ici, ou tronqué
+    if (readShort(bytes + 6) > version || size < headerSize || size > (size_t) sizeInBytes)
+        return false;
+
+    // Toutes les sections sont vérifiées avant d'en appliquer une : un bloc invalide ne change rien
+    std::array<std::pair<const char *, size_t>, 3> known {};
+
+    for (auto position = headerSize; position < size;)
+    {
+        if (size - position < sectionHeaderSize)
+            return false;
+
+        auto tag = readShort(bytes + position);
+        auto sectionSize = (size_t) readInt(bytes + position + 2);
+        position += sectionHeaderSize;
+
+        if (sectionSize > size - position)
+            return false;
+
+        if (tag < known.size())
+            known[tag] = { bytes + position, sectionSize };
+
+        position += sectionSize;
+    }
+
+    if (auto parameters = known[(size_t) Section::parameters]; parameters.first != nullptr)
+        readParameters(parameters.first, parameters.second);
+
+    if (auto properties = known[(size_t) Section::properties]; properties.first != nullptr)
+        readProperties(properties.first, properties.second);
+
+    return true;
+}
+
+void EqStateFormat::readParameters(const char *data, size_t size)
+{
+    if (size < 2)
+        return;
+
+    auto count = juce::jmin((size_t) readShort(data), (size - 2) / parameterSize);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto *item = data + 2 + i * parameterSize;
+        auto key = readInt(item);
+        auto value = readFloat(item + 4);
+
+        auto entry = std::lower_bound(entries.begin(), entries.end(), key,
+                                      [](const Entry &e, juce::uint32 k) { return e.key < k; });
+
+        // Comme replaceState() : seules les valeurs qui changent sont envoyées au paramètre (et à l'hôte)
+        if (entry != entries.end() && entry->key == key && std::isfinite(value) && value != entry->value->load())
+            entry->parameter->setValueNotifyingHost(entry->parameter->convertTo0to1(value));
+    }
+}
+
+void EqStateFormat::readProperties(const char *data, size_t size)
+{
+    juce::MemoryInputStream input(data, size, false);
+    juce::NamedValueSet properties;
+
+    for (int count = (juce::uint16) input.readShort(); count > 0 && ! input.isExhausted(); --count)
+    {
+        auto name = input.readString();
+        auto value = juce::var::readFromStream(input);
+
+        if (name.isNotEmpty())
+            properties.set(name, value);
+    }
+
+    // L'ancien état remplaçait tout l'arbre : les propriétés absentes du bloc disparaissent aussi
+    auto &tree = state.state;
+
+    for (int i = tree.getNumProperties(); --i >= 0;)
+    {
+        auto name = tree.getPropertyName(i);
+
+        if (! properties.contains(name))
+            tree.removeProperty(name, nullptr);
+    }
+
+    for (auto &property : properties)
+        tree.setProperty(property.name, property.value, nullptr);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+
+//==============================================================================
+/**
+    Format binaire de l'état du plugin, pour getStateInformation / setStateInformation.
+
+    L'écriture lit directement les valeurs des paramètres et les propriétés de l'arbre
+    de l'APVTS, sans copie de l'arbre ni XML. Le bloc commence par "SDEQ", la version
+    du format, la version minimale capable de le relire et la taille totale du bloc
+    (pour refuser un bloc tronqué), puis une suite de sections
+    (étiquette sur 16 bits, taille sur 32 bits, contenu), en little-endian :
+
+        parameters : nombre de paramètres, puis pour chacun l'empreinte de son
+                     identifiant (FNV-1a 32 bits de l'UTF-8) et sa valeur (float,
+                     dans l'unité du paramètre), triés par empreinte
+        properties : nombre de propriétés de l'arbre (oscPort...), puis pour chacune
+                     son nom (UTF-8 terminé par un zéro) et sa valeur (juce::var)
+
+    Compatibilité : un lecteur saute les sections qu'il ne connaît pas, ignore les
+    paramètres inconnus et laisse à leur valeur courante ceux qui manquent, comme
+    replaceState() avec l'ancien XML. Une nouvelle version du format n'augmente la
+    version minimale que si elle change le sens d'une section existante.
+*/
+class EqStateFormat
+{
+public:
+    static constexpr juce::uint32 magic = 0x51454453; // "SDEQ"
+    static constexpr int version = 1;
+
+    explicit EqStateFormat(juce::AudioProcessorValueTreeState &state);
+
+    // Thread de messages : écrit l'état courant, en remplaçant le contenu de destData
+    void write(juce::MemoryBlock &destData) const;
+
+    // Thread de messages : applique un bloc de ce format ; false s'il est invalide ou trop récent
+    bool read(const void *data, int sizeInBytes);
+
+    // Vrai si le bloc commence par l'en-tête de ce format (sinon : ancien état XML de copyXmlToBinary)
+    static bool isBinaryState(const void *data, int sizeInBytes) noexcept;
+
+    static juce::uint32 getParameterKey(const juce::String &parameterID) noexcept;
+
+private:
+    enum class Section : juce::uint16
+    {
+        parameters = 1,
+        properties = 2
+    };
+
+    struct Entry
+    {
+        juce::uint32 key;
+        juce::RangedAudioParameter *parameter;
+        std::atomic<float> *value;
+    };
+
+    void readParameters(const char *data, size_t size);
+
+    void readProperties(const char *data, size_t size);
+
+    juce::AudioProcessorValueTreeState &state;
+
+    // Triés par empreinte : l'écriture les parcourt dans l'ordre, la lecture fusionne les deux listes
+    std::vector<Entry> entries;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EqStateFormat)
+};
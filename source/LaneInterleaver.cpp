@@ -0,0 +1,235 @@
+#include "LaneInterleaver.h"
+
+#if defined(__SSE2__)
+ #define SDPEQ_INTERLEAVE_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(__aarch64__)
+ #define SDPEQ_INTERLEAVE_NEON 1
+#endif
+
+namespace
+{
+    // Transposition 4 canaux <-> 4 voies, 4 échantillons à la fois ; renvoie le nombre d'échantillons traités
+    size_t interleaveFour(const std::array<const float *, 4> &sources, float *dest, size_t numSamples) noexcept
+    {
+        size_t i = 0;
+
+       #if SDPEQ_INTERLEAVE_SSE
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            auto r0 = _mm_loadu_ps(sources[0] + i);
+            auto r1 = _mm_loadu_ps(sources[1] + i);
+            auto r2 = _mm_loadu_ps(sources[2] + i);
+            auto r3 = _mm_loadu_ps(sources[3] + i);
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            _mm_store_ps(dest + 4 * i, r0);
+            _mm_store_ps(dest + 4 * i + 4, r1);
+            _mm_store_ps(dest + 4 * i + 8, r2);
+            _mm_store_ps(dest + 4 * i + 12, r3);
+        }
+       #elif SDPEQ_INTERLEAVE_NEON
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            float32x4x4_t v{ { vld1q_f32(sources[0] + i), vld1q_f32(sources[1] + i),
+                               vld1q_f32(sources[2] + i), vld1q_f32(sources[3] + i) } };
+            vst4q_f32(dest + 4 * i, v);
+        }
+       #else
+        juce::ignoreUnused(sources, dest, numSamples);
+       #endif
+
+        return i;
+    }
+
+    size_t deinterleaveFour(const float *source, const std::array<float *, 4> &destinations, size_t numSamples) noexcept
+    {
+        size_t i = 0;
+
+       #if SDPEQ_INTERLEAVE_SSE
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            auto r0 = _mm_load_ps(source + 4 * i);
+            auto r1 = _mm_load_ps(source + 4 * i + 4);
+            auto r2 = _mm_load_ps(source + 4 * i + 8);
+            auto r3 = _mm_load_ps(source + 4 * i + 12);
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            _mm_storeu_ps(destinations[0] + i, r0);
+            _mm_storeu_ps(destinations[1] + i, r1);
+            _mm_storeu_ps(destinations[2] + i, r2);
+            _mm_storeu_ps(destinations[3] + i, r3);
+        }
+       #elif SDPEQ_INTERLEAVE_NEON
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            auto v = vld4q_f32(source + 4 * i);
+            vst1q_f32(destinations[0] + i, v.val[0]);
+            vst1q_f32(destinations[1] + i, v.val[1]);
+            vst1q_f32(destinations[2] + i, v.val[2]);
+            vst1q_f32(destinations[3] + i, v.val[3]);
+        }
+       #else
+        juce::ignoreUnused(source, destinations, numSamples);
+       #endif
+
+        return i;
+    }
+
+    // Transposition 2 canaux <-> 2 voies pour les doubles
+    size_t interleaveTwo(const std::array<const double *, 2> &sources, double *dest, size_t numSamples) noexcept
+    {
+        size_t i = 0;
+
+       #if SDPEQ_INTERLEAVE_SSE
+        for (; i + 2 <= numSamples; i += 2)
+        {
+            auto r0 = _mm_loadu_pd(sources[0] + i);
+            auto r1 = _mm_loadu_pd(sources[1] + i);
+            _mm_store_pd(dest + 2 * i, _mm_unpacklo_pd(r0, r1));
+            _mm_store_pd(dest + 2 * i + 2, _mm_unpackhi_pd(r0, r1));
+        }
+       #elif SDPEQ_INTERLEAVE_NEON && defined(__aarch64__)
+        for (; i + 2 <= numSamples; i += 2)
+        {
+            float64x2x2_t v{ { vld1q_f64(sources[0] + i), vld1q_f64(sources[1] + i) } };
+            vst2q_f64(dest + 2 * i, v);
+        }
+       #else
+        juce::ignoreUnused(sources, dest, numSamples);
+       #endif
+
+        return i;
+    }
+
+    size_t deinterleaveTwo(const double *source, const std::array<double *, 2> &destinations, size_t numSamples) noexcept
+    {
+        size_t i = 0;
+
+       #if SDPEQ_INTERLEAVE_SSE
+        for (; i + 2 <= numSamples; i += 2)
+        {
+            auto r0 = _mm_load_pd(source + 2 * i);
+            auto r1 = _mm_load_pd(source + 2 * i + 2);
+            _mm_storeu_pd(destinations[0] + i, _mm_unpacklo_pd(r0, r1));
+            _mm_storeu_pd(destinations[1] + i, _mm_unpackhi_pd(r0, r1));
+        }
+       #elif SDPEQ_INTERLEAVE_NEON && defined(__aarch64__)
+        for (; i + 2 <= numSamples; i += 2)
+        {
+            auto v = vld2q_f64(source + 2 * i);
+            vst1q_f64(destinations[0] + i, v.val[0]);
+            vst1q_f64(destinations[1] + i, v.val[1]);
+        }
+       #else
+        juce::ignoreUnused(source, destinations, numSamples);
+       #endif
+
+        return i;
+    }
+
+    // Transposition native quand elle existe pour ce type et ce nombre de voies ; sinon 0, tout passe par la boucle scalaire
+    template <typename InputType, typename SampleType, size_t NumLanes>
+    size_t interleaveNative(const std::array<const InputType *, NumLanes> &sources, SampleType *dest, size_t numSamples) noexcept
+    {
+        if constexpr (std::is_same_v<InputType, float> && std::is_same_v<SampleType, float> && NumLanes == 4)
+            return interleaveFour(sources, dest, numSamples);
+        else if constexpr (std::is_same_v<InputType, double> && std::is_same_v<SampleType, double> && NumLanes == 2)
+            return interleaveTwo(sources, dest, numSamples);
+        else
+            return 0;
+    }
+
+    template <typename OutputType, typename SampleType, size_t NumLanes>
+    size_t deinterleaveNative(const SampleType *source, const std::array<OutputType *, NumLanes> &destinations, size_t numSamples) noexcept
+    {
+        if constexpr (std::is_same_v<OutputType, float> && std::is_same_v<SampleType, float> && NumLanes == 4)
+            return deinterleaveFour(source, destinations, numSamples);
+        else if constexpr (std::is_same_v<OutputType, double> && std::is_same_v<SampleType, double> && NumLanes == 2)
+            return deinterleaveTwo(source, destinations, numSamples);
+        else
+            return 0;
+    }
+}
+
+//==============================================================================
+template <typename SampleType>
+void LaneInterleaver<SampleType>::prepare(const juce::dsp::ProcessSpec &spec)
+{
+    numChannels = spec.numChannels;
+
+    interleaved = juce::dsp::AudioBlock<Lanes>(interleavedData, juce::jmax((size_t) 1, getNumGroups(numChannels)), spec.maximumBlockSize);
+    zero = juce::dsp::AudioBlock<double>(zeroData, 1, spec.maximumBlockSize);
+    discard = juce::dsp::AudioBlock<double>(discardData, 1, spec.maximumBlockSize);
+
+    interleaved.clear();
+    zero.clear();
+}
+
+template <typename SampleType>
+template <typename InputType>
+juce::dsp::AudioBlock<typename LaneInterleaver<SampleType>::Lanes>
+    LaneInterleaver<SampleType>::interleave(const juce::dsp::AudioBlock<const InputType> &block) noexcept
+{
+    jassert(block.getNumChannels() <= numChannels);
+    jassert(block.getNumSamples() <= interleaved.getNumSamples());
+
+    numSamples = block.getNumSamples();
+    auto numGroups = getNumGroups(block.getNumChannels());
+    auto *zeros = reinterpret_cast<const InputType *>(zero.getChannelPointer(0));
+
+    for (size_t group = 0; group < numGroups; ++group)
+    {
+        std::array<const InputType *, numLanes> sources;
+
+        for (size_t lane = 0; lane < numLanes; ++lane)
+        {
+            auto channel = group * numLanes + lane;
+            sources[lane] = channel < block.getNumChannels() ? block.getChannelPointer(channel) : zeros;
+        }
+
+        auto *dest = reinterpret_cast<SampleType *>(interleaved.getChannelPointer(group));
+        auto done = interleaveNative(sources, dest, numSamples);
+
+        for (size_t lane = 0; lane < numLanes; ++lane)
+            for (size_t i = done; i < numSamples; ++i)
+                dest[i * numLanes + lane] = static_cast<SampleType>(sources[lane][i]);
+    }
+
+    return interleaved.getSubBlock(0, numSamples).getSubsetChannelBlock(0, numGroups);
+}
+
+template <typename SampleType>
+template <typename OutputType>
+void LaneInterleaver<SampleType>::deinterleave(const juce::dsp::AudioBlock<OutputType> &block) noexcept
+{
+    jassert(block.getNumSamples() == numSamples);
+
+    auto numGroups = getNumGroups(block.getNumChannels());
+    auto *discarded = reinterpret_cast<OutputType *>(discard.getChannelPointer(0));
+
+    for (size_t group = 0; group < numGroups; ++group)
+    {
+        std::array<OutputType *, numLanes> destinations;
+
+        for (size_t lane = 0; lane < numLanes; ++lane)
+        {
+            auto channel = group * numLanes + lane;
+            destinations[lane] = channel < block.getNumChannels() ? block.getChannelPointer(channel) : discarded;
+        }
+
+        auto *source = reinterpret_cast<const SampleType *>(interleaved.getChannelPointer(group));
+        auto done = deinterleaveNative(source, destinations, numSamples);
+
+        for (size_t lane = 0; lane < numLanes; ++lane)
+            for (size_t i = done; i < numSamples; ++i)
+                destinations[lane][i] = static_cast<OutputType>(source[i * numLanes + lane]);
+    }
+}
+
+template class LaneInterleaver<float>;
+template class LaneInterleaver<double>;
+
+template juce::dsp::AudioBlock<LaneInterleaver<float>::Lanes> LaneInterleaver<float>::interleave(const juce::dsp::AudioBlock<const float> &) noexcept;
+template juce::dsp::AudioBlock<LaneInterleaver<double>::Lanes> LaneInterleaver<double>::interleave(const juce::dsp::AudioBlock<const float> &) noexcept;
+template juce::dsp::AudioBlock<LaneInterleaver<double>::Lanes> LaneInterleaver<double>::interleave(const juce::dsp::AudioBlock<const double> &) noexcept;
+template void LaneInterleaver<float>::deinterleave(const juce::dsp::AudioBlock<float> &) noexcept;
+template void LaneInterleaver<double>::deinterleave(const juce::dsp::AudioBlock<float> &) noexcept;
+template void LaneInterleaver<double>::deinterleave(const juce::dsp::AudioBlock<double> &) noexcept;
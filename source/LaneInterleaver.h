@@ -0,0 +1,51 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+/**
+    Conversion entre un AudioBlock<float> ou <double> (un tableau par canal) et un
+    bloc de juce::dsp::SIMDRegister<SampleType>, où chaque registre contient le même
+    échantillon de plusieurs canaux. Les canaux sont regroupés par paquets de numLanes
+    (4 floats ou 2 doubles en SSE et NEON, deux fois plus en AVX) : le canal c est
+    dans la voie c % numLanes du groupe c / numLanes. Quand le bloc et les voies ont
+    le même type, la conversion se fait par transpositions 4x4 (float) ou 2x2 (double)
+    dans les registres natifs ; sinon les échantillons sont convertis un par un (bloc
+    float traité avec un état en double).
+
+    Tout est alloué dans prepare() : interleave() et deinterleave() peuvent être
+    appelées depuis le thread audio.
+*/
+template <typename SampleType>
+class LaneInterleaver
+{
+public:
+    using Lanes = juce::dsp::SIMDRegister<SampleType>;
+
+    static constexpr size_t numLanes = Lanes::size();
+
+    static size_t getNumGroups(size_t numChannels) noexcept { return (numChannels + numLanes - 1) / numLanes; }
+
+    void prepare(const juce::dsp::ProcessSpec &spec);
+
+    // Renvoie les échantillons de block entrelacés, un canal du bloc renvoyé par groupe de canaux
+    template <typename InputType>
+    juce::dsp::AudioBlock<Lanes> interleave(const juce::dsp::AudioBlock<const InputType> &block) noexcept;
+
+    // Recopie le résultat du dernier interleave() dans block, qui doit avoir la même taille
+    template <typename OutputType>
+    void deinterleave(const juce::dsp::AudioBlock<OutputType> &block) noexcept;
+
+private:
+    juce::HeapBlock<char> interleavedData, zeroData, discardData;
+    juce::dsp::AudioBlock<Lanes> interleaved;
+
+    // Voies sans canal : lues dans zero, écrites dans discard (assez grands pour des doubles)
+    juce::dsp::AudioBlock<double> zero, discard;
+
+    size_t numChannels = 0;
+    size_t numSamples = 0;
+
+    //==============================================================================
+    JUCE_LEAK_DETECTOR(LaneInterleaver)
+};
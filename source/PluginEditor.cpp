@@ -3,120 +3,156 @@
 
 //==============================================================================
 AudioPluginAudioProcessorEditor::AudioPluginAudioProcessorEditor (AudioPluginAudioProcessor& p)
-    : AudioProcessorEditor (&p), processorRef (p), parameters(p.getValueTreeState())
+    : AudioProcessorEditor (&p), processorRef (p), parameters(p.getValueTreeState()),
+      spectrumDisplay(p.getAnalyser(), p.getEqParameters()), loadMeter(p.getLoadMonitor())
 {
-    // Configuration des sliders et labels pour EQ1
-
-    // EQ1 Fréquence
-    eq1FreqSlider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
-    eq1FreqSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 60, 20);
-    addAndMakeVisible(eq1FreqSlider);
-
-    eq1FreqLabel.setText("Freq", juce::dontSendNotification);
-    eq1FreqLabel.attachToComponent(&eq1FreqSlider, false);
-    addAndMakeVisible(eq1FreqLabel);
-
-    // EQ1 Gain
-    eq1GainSlider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
-    eq1GainSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 60, 20);
-    addAndMakeVisible(eq1GainSlider);
-
-    eq1GainLabel.setText("Gain", juce::dontSendNotification);
-    eq1GainLabel.attachToComponent(&eq1GainSlider, false);
-    addAndMakeVisible(eq1GainLabel);
-
-    // EQ1 Q
-    eq1QSlider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
-    eq1QSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 60, 20);
-    addAndMakeVisible(eq1QSlider);
-
-    eq1QLabel.setText("Q", juce::dontSendNotification);
-    eq1QLabel.attachToComponent(&eq1QSlider, false);
-    addAndMakeVisible(eq1QLabel);
-
-    // EQ1 On/Off
-    eq1OnButton.setButtonText("On");
-    addAndMakeVisible(eq1OnButton);
-
-    // Configuration des sliders et labels pour EQ2
-
-    // EQ2 Fréquence
-    eq2FreqSlider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
-    eq2FreqSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 60, 20);
-    addAndMakeVisible(eq2FreqSlider);
-
-    eq2FreqLabel.setText("Freq", juce::dontSendNotification);
-    eq2FreqLabel.attachToComponent(&eq2FreqSlider, false);
-    addAndMakeVisible(eq2FreqLabel);
-
-    // EQ2 Gain
-    eq2GainSlider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
-    eq2GainSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 60, 20);
-    addAndMakeVisible(eq2GainSlider);
-
-    eq2GainLabel.setText("Gain", juce::dontSendNotification);
-    eq2GainLabel.attachToComponent(&eq2GainSlider, false);
-    addAndMakeVisible(eq2GainLabel);
-
-    // EQ2 Q
-    eq2QSlider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
-    eq2QSlider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 60, 20);
-    addAndMakeVisible(eq2QSlider);
-
-    eq2QLabel.setText("Q", juce::dontSendNotification);
-    eq2QLabel.attachToComponent(&eq2QSlider, false);
-    addAndMakeVisible(eq2QLabel);
-
-    // EQ2 On/Off
-    eq2OnButton.setButtonText("On");
-    addAndMakeVisible(eq2OnButton);
-
-    // Attachments pour lier les sliders aux paramètres
-    eq1FreqAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        parameters, "EQ1_FREQ", eq1FreqSlider);
-    eq1GainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        parameters, "EQ1_GAIN", eq1GainSlider);
-    eq1QAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        parameters, "EQ1_Q", eq1QSlider);
-    eq1OnAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
-        parameters, "EQ1_ON", eq1OnButton);
-
-    eq2FreqAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        parameters, "EQ2_FREQ", eq2FreqSlider);
-    eq2GainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        parameters, "EQ2_GAIN", eq2GainSlider);
-    eq2QAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
-        parameters, "EQ2_Q", eq2QSlider);
-    eq2OnAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
-        parameters, "EQ2_ON", eq2OnButton);
-
-    // Configuration des limites des sliders
-    // EQ1
-    eq1FreqSlider.setRange(20.0, 20000.0, 1.0);
-    eq1FreqSlider.setSkewFactorFromMidPoint(1000.0);
-
-    eq1GainSlider.setRange(-24.0, 24.0, 0.1);
-    eq1GainSlider.setSkewFactorFromMidPoint(0.0);
-
-    eq1QSlider.setRange(0.1, 10.0, 0.1);
-    eq1QSlider.setSkewFactor(1.0); // Linéaire
-
-    // EQ2
-    eq2FreqSlider.setRange(20.0, 20000.0, 1.0);
-    eq2FreqSlider.setSkewFactorFromMidPoint(5000.0);
-
-    eq2GainSlider.setRange(-24.0, 24.0, 0.1);
-    eq2GainSlider.setSkewFactorFromMidPoint(0.0);
-
-    eq2QSlider.setRange(0.1, 10.0, 0.1);
-    eq2QSlider.setSkewFactor(1.0); // Linéaire
-
-    // Définir la taille de l'éditeur
-    setSize (350, 450);
+    addAndMakeVisible(spectrumDisplay);
+
+    // Configuration des sliders et labels de chaque bande
+    for (auto &band : bands)
+    {
+        setUpRotarySlider(band.freqSlider, band.freqLabel, "Freq");
+        setUpRotarySlider(band.gainSlider, band.gainLabel, "Gain");
+        setUpRotarySlider(band.qSlider, band.qLabel, "Q");
+
+        band.onButton.setButtonText("On");
+        addAndMakeVisible(band.onButton);
+
+        // Les choix doivent exister avant l'attachment, qui sélectionne l'élément courant
+        band.typeBox.addItemList(EqParameters::getTypeChoices(), 1);
+        addAndMakeVisible(band.typeBox);
+
+        band.routingBox.addItemList(EqParameters::getRoutingChoices(), 1);
+        addAndMakeVisible(band.routingBox);
+
+        band.dynamicButton.setButtonText("Dyn");
+        addAndMakeVisible(band.dynamicButton);
+
+        band.sidechainButton.setButtonText("SC");
+        addAndMakeVisible(band.sidechainButton);
+
+        band.thresholdSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+        band.thresholdSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 40, 20);
+        band.thresholdSlider.setTextValueSuffix(" dB");
+        addAndMakeVisible(band.thresholdSlider);
+    }
+
+    // Télécommande OSC : le port est sauvegardé dans l'état du plugin
+    oscPortLabel.setText("OSC port", juce::dontSendNotification);
+    oscPortLabel.attachToComponent(&oscPortEditor, true);
+    addAndMakeVisible(oscPortLabel);
+
+    auto oscPort = (int) parameters.state.getProperty(EqOscServer::portProperty, 0);
+    oscPortEditor.setText(oscPort > 0 ? juce::String(oscPort) : juce::String(), juce::dontSendNotification);
+    oscPortEditor.setEditable(true);
+    oscPortEditor.setJustificationType(juce::Justification::centred);
+    oscPortEditor.onTextChange = [this]
+    {
+        auto port = juce::jlimit(0, 65535, oscPortEditor.getText().getIntValue());
+        oscPortEditor.setText(port > 0 ? juce::String(port) : juce::String(), juce::dontSendNotification);
+        parameters.state.setProperty(EqOscServer::portProperty, port, nullptr);
+    };
+    addAndMakeVisible(oscPortEditor);
+
+    // Charge DSP, publiée par OSC vers le port choisi ici (sur l'hôte oscLoadHost de l'état)
+    if (EqLoadMonitor::isEnabled)
+    {
+        addAndMakeVisible(loadMeter);
+
+        loadPortLabel.setText("Load", juce::dontSendNotification);
+        loadPortLabel.attachToComponent(&loadPortEditor, true);
+        addAndMakeVisible(loadPortLabel);
+
+        auto loadPort = (int) parameters.state.getProperty(EqOscServer::loadPortProperty, 0);
+        loadPortEditor.setText(loadPort > 0 ? juce::String(loadPort) : juce::String(), juce::dontSendNotification);
+        loadPortEditor.setEditable(true);
+        loadPortEditor.setJustificationType(juce::Justification::centred);
+        loadPortEditor.onTextChange = [this]
+        {
+            auto port = juce::jlimit(0, 65535, loadPortEditor.getText().getIntValue());
+            loadPortEditor.setText(port > 0 ? juce::String(port) : juce::String(), juce::dontSendNotification);
+            parameters.state.setProperty(EqOscServer::loadPortProperty, port, nullptr);
+        };
+        addAndMakeVisible(loadPortEditor);
+    }
+
+    processorRef.getOscServer().onConnectionChanged = [this] { updateOscStatus(); };
+    updateOscStatus();
+
+    for (int i = 0; i < EqParameters::numBands; ++i)
+    {
+        auto &band = bands[(size_t) i];
+
+        // Attachments pour lier les sliders aux paramètres
+        band.freqAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+            parameters, EqParameters::getParameterID(i, EqParameters::BandField::freq), band.freqSlider);
+        band.gainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+            parameters, EqParameters::getParameterID(i, EqParameters::BandField::gain), band.gainSlider);
+        band.qAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+            parameters, EqParameters::getParameterID(i, EqParameters::BandField::q), band.qSlider);
+        band.onAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+            parameters, EqParameters::getParameterID(i, EqParameters::BandField::on), band.onButton);
+        band.typeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+            parameters, EqParameters::getParameterID(i, EqParameters::BandField::type), band.typeBox);
+        band.routingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+            parameters, EqParameters::getParameterID(i, EqParameters::BandField::routing), band.routingBox);
+        band.dynamicAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+            parameters, EqParameters::getParameterID(i, EqParameters::BandField::dynamic), band.dynamicButton);
+        band.sidechainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+            parameters, EqParameters::getParameterID(i, EqParameters::BandField::sidechain), band.sidechainButton);
+        band.thresholdAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+            parameters, EqParameters::getParameterID(i, EqParameters::BandField::threshold), band.thresholdSlider);
+
+        // Configuration des limites des sliders
+        band.freqSlider.setRange(20.0, 20000.0, 1.0);
+        band.freqSlider.setSkewFactorFromMidPoint(EqParameters::getDefaultFrequency(i));
+
+        band.gainSlider.setRange(-24.0, 24.0, 0.1);
+        band.gainSlider.setSkewFactorFromMidPoint(0.0);
+
+        band.qSlider.setRange(0.1, 10.0, 0.1);
+        band.qSlider.setSkewFactor(1.0); // Linéaire
+    }
+
+    // Définir la taille de l'éditeur : une colonne par bande
+    setSize (juce::jmax(350, EqParameters::numBands * bandColumnWidth + 40), 520 + spectrumHeight + 10 + routingHeight + dynamicsHeight + loadMeterHeight);
+}
+
+void AudioPluginAudioProcessorEditor::setUpRotarySlider(juce::Slider &slider, juce::Label &label, const juce::String &name)
+{
+    slider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
+    slider.setTextBoxStyle(juce::Slider::TextBoxBelow, true, 60, 20);
+    addAndMakeVisible(slider);
+
+    label.setText(name, juce::dontSendNotification);
+    label.attachToComponent(&slider, false);
+    addAndMakeVisible(label);
 }
 
 AudioPluginAudioProcessorEditor::~AudioPluginAudioProcessorEditor()
 {
+    processorRef.getOscServer().onConnectionChanged = nullptr;
+}
+
+void AudioPluginAudioProcessorEditor::updateOscStatus()
+{
+    auto &oscServer = processorRef.getOscServer();
+
+    auto oscPort = (int) parameters.state.getProperty(EqOscServer::portProperty, 0);
+    auto oscFailed = oscPort > 0 && ! oscServer.isConnected();
+
+    oscPortEditor.setColour(juce::Label::outlineColourId, oscFailed ? juce::Colours::red : juce::Colours::grey);
+    oscPortEditor.setTooltip(oscFailed ? "Could not listen on UDP port " + juce::String(oscPort) : juce::String());
+
+    if (! EqLoadMonitor::isEnabled)
+        return;
+
+    auto loadPort = (int) parameters.state.getProperty(EqOscServer::loadPortProperty, 0);
+    auto loadHost = parameters.state.getProperty(EqOscServer::loadHostProperty, "127.0.0.1").toString();
+    auto loadFailed = loadPort > 0 && ! oscServer.isPublishingLoad();
+
+    loadPortEditor.setColour(juce::Label::outlineColourId, loadFailed ? juce::Colours::red : juce::Colours::grey);
+    loadPortEditor.setTooltip(loadFailed ? "Could not send to " + loadHost + ":" + juce::String(loadPort) : juce::String());
 }
 
 //==============================================================================
@@ -128,46 +164,59 @@ void AudioPluginAudioProcessorEditor::paint (juce::Graphics& g)
     // Dessiner le titre
     g.setColour (juce::Colours::white);
     g.setFont (20.0f);
-    g.drawFittedText ("Dual Parametric EQ", getLocalBounds().removeFromTop(30), juce::Justification::centred, 1);
+    g.drawFittedText (EqParameters::numBands == 2 ? juce::String("Dual Parametric EQ")
+                                                  : juce::String(EqParameters::numBands) + "-Band Parametric EQ", getLocalBounds().removeFromTop(30), juce::Justification::centred, 1);
 }
 
 void AudioPluginAudioProcessorEditor::resized()
 {
-    // Définir les zones pour les EQs
+    spectrumDisplay.setBounds(20, 40, getWidth() - 40, spectrumHeight);
+
+    // Une zone de même largeur par bande, sous le spectre
     auto area = getLocalBounds().reduced(20);
-    auto eq1Area = area.removeFromLeft(getWidth() / 2 - 30);
-    auto eq2Area = area;
+    auto bandWidth = area.getWidth() / EqParameters::numBands;
 
-    // Positionnement des contrôles pour EQ1
     int sliderDiameter = 80;
     int labelHeight = 20;
     int padding = 10;
 
-    // Arrange EQ1 sliders vertically
-    int currentY = 60;
+    for (auto &band : bands)
+    {
+        auto bandArea = area.removeFromLeft(bandWidth);
+
+        // Arrange sliders vertically
+        int currentY = 60 + spectrumHeight + 10;
+
+        band.freqSlider.setBounds(bandArea.getX() + (bandArea.getWidth() - sliderDiameter) / 2, currentY, sliderDiameter, sliderDiameter);
+        currentY += sliderDiameter + labelHeight + padding;
 
-    eq1FreqSlider.setBounds(eq1Area.getX() + (eq1Area.getWidth() - sliderDiameter) / 2, currentY, sliderDiameter, sliderDiameter);
-    currentY += sliderDiameter + labelHeight + padding;
+        band.gainSlider.setBounds(bandArea.getX() + (bandArea.getWidth() - sliderDiameter) / 2, currentY, sliderDiameter, sliderDiameter);
+        currentY += sliderDiameter + labelHeight + padding;
 
-    eq1GainSlider.setBounds(eq1Area.getX() + (eq1Area.getWidth() - sliderDiameter) / 2, currentY, sliderDiameter, sliderDiameter);
-    currentY += sliderDiameter + labelHeight + padding;
+        band.qSlider.setBounds(bandArea.getX() + (bandArea.getWidth() - sliderDiameter) / 2, currentY, sliderDiameter, sliderDiameter);
+        currentY += sliderDiameter + labelHeight + padding;
 
-    eq1QSlider.setBounds(eq1Area.getX() + (eq1Area.getWidth() - sliderDiameter) / 2, currentY, sliderDiameter, sliderDiameter);
-    currentY += sliderDiameter + labelHeight + padding;
+        band.onButton.setBounds(bandArea.getX() + (bandArea.getWidth() - 60) / 2, currentY, 60, 30);
+        currentY += 30 + padding;
 
-    eq1OnButton.setBounds(eq1Area.getX() + (eq1Area.getWidth() - 60) / 2, currentY, 60, 30);
+        band.typeBox.setBounds(bandArea.getX() + (bandArea.getWidth() - 100) / 2, currentY, 100, 24);
+        currentY += 24 + padding;
 
-    // Positionnement des contrôles pour EQ2
-    currentY = 60;
+        band.routingBox.setBounds(bandArea.getX() + (bandArea.getWidth() - 100) / 2, currentY, 100, 24);
+        currentY += 24 + padding;
 
-    eq2FreqSlider.setBounds(eq2Area.getX() + (eq2Area.getWidth() - sliderDiameter) / 2, currentY, sliderDiameter, sliderDiameter);
-    currentY += sliderDiameter + labelHeight + padding;
+        // Mode dynamique : les deux interrupteurs côte à côte, le seuil en dessous
+        band.dynamicButton.setBounds(bandArea.getX() + bandArea.getWidth() / 2 - 50, currentY, 50, 30);
+        band.sidechainButton.setBounds(bandArea.getX() + bandArea.getWidth() / 2, currentY, 50, 30);
+        currentY += 30;
 
-    eq2GainSlider.setBounds(eq2Area.getX() + (eq2Area.getWidth() - sliderDiameter) / 2, currentY, sliderDiameter, sliderDiameter);
-    currentY += sliderDiameter + labelHeight + padding;
+        band.thresholdSlider.setBounds(bandArea.getX() + (bandArea.getWidth() - 100) / 2, currentY, 100, 24);
+    }
 
-    eq2QSlider.setBounds(eq2Area.getX() + (eq2Area.getWidth() - sliderDiameter) / 2, currentY, sliderDiameter, sliderDiameter);
-    currentY += sliderDiameter + labelHeight + padding;
+    // Charge DSP sur toute la largeur, au-dessus du port OSC
+    loadMeter.setBounds(20, getHeight() - 40 - loadMeterHeight, getWidth() - 40, 20);
 
-    eq2OnButton.setBounds(eq2Area.getX() + (eq2Area.getWidth() - 60) / 2, currentY, 60, 30);
+    // Port OSC, centré sous les bandes, et port de publication de la charge à droite
+    oscPortEditor.setBounds(getWidth() / 2, getHeight() - 40, 70, 24);
+    loadPortEditor.setBounds(getWidth() - 70, getHeight() - 40, 50, 24);
 }
@@ -3,6 +3,8 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_graphics/juce_graphics.h>
 #include "PluginProcessor.h"
+#include "EqLoadMeter.h"
+#include "EqSpectrumDisplay.h"
 
 //==============================================================================
 class AudioPluginAudioProcessorEditor  : public juce::AudioProcessorEditor
@@ -22,38 +24,68 @@ private:
     // ValueTreeState pour lier les paramètres
     juce::AudioProcessorValueTreeState& parameters;
 
-    // Sliders et Labels pour EQ1
-    juce::Slider eq1FreqSlider;
-    juce::Slider eq1GainSlider;
-    juce::Slider eq1QSlider;
-    juce::ToggleButton eq1OnButton;
-
-    juce::Label eq1FreqLabel;
-    juce::Label eq1GainLabel;
-    juce::Label eq1QLabel;
-    // Pas de label séparé pour le bouton On/Off
-
-    // Sliders et Labels pour EQ2
-    juce::Slider eq2FreqSlider;
-    juce::Slider eq2GainSlider;
-    juce::Slider eq2QSlider;
-    juce::ToggleButton eq2OnButton;
-
-    juce::Label eq2FreqLabel;
-    juce::Label eq2GainLabel;
-    juce::Label eq2QLabel;
-    // Pas de label séparé pour le bouton On/Off
-
-    // Attachments pour lier les sliders aux paramètres
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> eq1FreqAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> eq1GainAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> eq1QAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> eq1OnAttachment;
-
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> eq2FreqAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> eq2GainAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> eq2QAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> eq2OnAttachment;
+    // Sliders, labels et attachments d'une bande
+    struct BandControls
+    {
+        juce::Slider freqSlider;
+        juce::Slider gainSlider;
+        juce::Slider qSlider;
+        juce::ToggleButton onButton;
+        juce::ComboBox typeBox;
+        juce::ComboBox routingBox;
+
+        // Mode dynamique : seuil ici, taux et temps dans les paramètres de l'hôte
+        juce::ToggleButton dynamicButton;
+        juce::ToggleButton sidechainButton;
+        juce::Slider thresholdSlider;
+
+        juce::Label freqLabel;
+        juce::Label gainLabel;
+        juce::Label qLabel;
+        // Pas de label séparé pour le bouton On/Off
+
+        std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> freqAttachment;
+        std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> gainAttachment;
+        std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> qAttachment;
+        std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> onAttachment;
+        std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> typeAttachment;
+        std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> routingAttachment;
+        std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> dynamicAttachment;
+        std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> sidechainAttachment;
+        std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> thresholdAttachment;
+    };
+
+    // Une colonne de contrôles par bande, de gauche à droite
+    static constexpr int bandColumnWidth = 110;
+
+    // Hauteur ajoutée sous chaque bande par le choix du routage et par les contrôles du mode dynamique
+    static constexpr int routingHeight = 34;
+    static constexpr int dynamicsHeight = 70;
+
+    std::array<BandControls, EqParameters::numBands> bands;
+
+    void setUpRotarySlider(juce::Slider &slider, juce::Label &label, const juce::String &name);
+
+    // Spectre avant et après l'EQ et réponse des bandes, au-dessus des bandes
+    static constexpr int spectrumHeight = 160;
+
+    EqSpectrumDisplay spectrumDisplay;
+
+    // Port UDP de la télécommande OSC (vide ou 0 : désactivée), encadré en rouge s'il n'a pas pu être ouvert
+    juce::Label oscPortLabel;
+    juce::Label oscPortEditor;
+
+    juce::TooltipWindow tooltipWindow { this };
+
+    // Thread de messages : reflète dans les champs de port l'échec éventuel des connexions OSC
+    void updateOscStatus();
+
+    // Charge DSP, au-dessus du port OSC, et port de destination de sa publication par OSC, à côté de lui
+    static constexpr int loadMeterHeight = EqLoadMonitor::isEnabled ? 28 : 0;
+
+    EqLoadMeter loadMeter;
+    juce::Label loadPortLabel;
+    juce::Label loadPortEditor;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioPluginAudioProcessorEditor)
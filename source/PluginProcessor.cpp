@@ -1,6 +1,24 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+namespace
+{
+    // Vrai si tous les échantillons du bloc sont entre -threshold et threshold
+    template <typename SampleType>
+    bool isSilent(const juce::dsp::AudioBlock<SampleType> &block, SampleType threshold) noexcept
+    {
+        for (size_t channel = 0; channel < block.getNumChannels(); ++channel)
+        {
+            auto range = juce::FloatVectorOperations::findMinAndMax(block.getChannelPointer(channel), (int) block.getNumSamples());
+
+            if (range.getStart() < -threshold || range.getEnd() > threshold)
+                return false;
+        }
+
+        return true;
+    }
+}
+
 //==============================================================================
 AudioPluginAudioProcessor::AudioPluginAudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -8,30 +26,31 @@ AudioPluginAudioProcessor::AudioPluginAudioProcessor()
                      #if ! JucePlugin_IsMidiEffect
                       #if ! JucePlugin_IsSynth
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                       .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                      #endif
                        ),
-       parameters(*this, nullptr, juce::Identifier("PARAMETERS"),
-       {
-           // EQ1 Parameters
-           std::make_unique<juce::AudioParameterFloat>("EQ1_FREQ", "EQ1 Frequency", logRange(20.0f, 20000.0f), 1000.0f),
-           std::make_unique<juce::AudioParameterFloat>("EQ1_GAIN", "EQ1 Gain", -24.0f, 24.0f, 0.0f),
-           std::make_unique<juce::AudioParameterFloat>("EQ1_Q", "EQ1 Q", 0.1f, 10.0f, 1.0f),
-           std::make_unique<juce::AudioParameterBool>("EQ1_ON", "EQ1 On", true),
-
-           // EQ2 Parameters
-           std::make_unique<juce::AudioParameterFloat>("EQ2_FREQ", "EQ2 Frequency", logRange(20.0f, 20000.0f), 5000.0f),
-           std::make_unique<juce::AudioParameterFloat>("EQ2_GAIN", "EQ2 Gain", -24.0f, 24.0f, 0.0f),
-           std::make_unique<juce::AudioParameterFloat>("EQ2_Q", "EQ2 Q", 0.1f, 10.0f, 1.0f),
-           std::make_unique<juce::AudioParameterBool>("EQ2_ON", "EQ2 On", true),
-       })
+       parameters(*this, nullptr, juce::Identifier("PARAMETERS"), EqParameters::createParameterLayout())
 #endif
 {
+    parameters.addParameterListener("PHASE_MODE", this);
+    parameters.addParameterListener("FIR_LENGTH", this);
+    parameters.addParameterListener("OVERSAMPLING", this);
+    parameters.addParameterListener("OVERSAMPLING_FILTER", this);
+
+    loadMonitor.onUpdate = [this] { oscServer.publishLoad(loadMonitor.getStatistics()); };
+
+    startTimerHz(latencyPollRateHz);
 }
 
 AudioPluginAudioProcessor::~AudioPluginAudioProcessor()
 {
+    parameters.removeParameterListener("PHASE_MODE", this);
+    parameters.removeParameterListener("FIR_LENGTH", this);
+    parameters.removeParameterListener("OVERSAMPLING", this);
+    parameters.removeParameterListener("OVERSAMPLING_FILTER", this);
+    stopTimer();
 }
 
 //==============================================================================
@@ -67,9 +86,11 @@ bool AudioPluginAudioProcessor::isMidiEffect() const
    #endif
 }
 
+// Thread de messages : seulement des lectures atomiques (fréquence de l'hôte, paramètres des bandes)
 double AudioPluginAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    auto sampleRate = hostSampleRate.load(std::memory_order_relaxed);
+    return getTailSamples(sampleRate) / sampleRate;
 }
 
 int AudioPluginAudioProcessor::getNumPrograms()
@@ -104,14 +125,90 @@ void AudioPluginAudioProcessor::prepareToPlay (double sampleRate, int samplesPer
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = sampleRate;
     spec.maximumBlockSize = samplesPerBlock;
-    spec.numChannels = getTotalNumInputChannels();
+    // Le sidechain ne passe pas par l'EQ : seulement les canaux du bus principal
+    preparedNumChannels = juce::jmin(getMainBusNumInputChannels(), maxNumChannels);
+    spec.numChannels = (juce::uint32) preparedNumChannels;
+
+    // Le moteur tourne directement au réglage de suréchantillonnage courant ; ses blocs peuvent être
+    // jusqu'à 2 ^ maxOversamplingOrder fois plus longs que ceux de l'hôte
+    hostSampleRate.store(sampleRate, std::memory_order_relaxed);
+    oversamplingOrder = eqParameters.getOversamplingOrder();
+    oversamplingLinearPhase = eqParameters.isOversamplingFilterLinearPhase();
+    oversampling.prepare(spec, isUsingDoublePrecision());
+
+    auto engineSpec = spec;
+    engineSpec.sampleRate = sampleRate * (1 << oversamplingOrder);
+    engineSpec.maximumBlockSize = spec.maximumBlockSize << EqParameters::maxOversamplingOrder;
+
+    // L'hôte choisit la précision avant prepareToPlay : seul le moteur correspondant sert
+    if (isUsingDoublePrecision())
+        doubleEngine.prepare(engineSpec, getChannelLayoutOfBus(true, 0));
+    else
+        floatEngine.prepare(engineSpec, getChannelLayoutOfBus(true, 0));
+
+    linearPhase.prepare(spec);
+    linearPhaseActive = false;
+    dynamics.prepare(sampleRate, samplesPerBlock);
+    analyser.prepare(sampleRate);
+    silentSamples = 0;
+    idle = false;
+    outputSilent = false;
+    loadMonitor.prepare(sampleRate, samplesPerBlock);
+    setLatencySamples(getCurrentLatency());
+}
+
+int AudioPluginAudioProcessor::getCurrentLatency() const noexcept
+{
+    if (isLinearPhaseLoaded())
+        return EqLinearPhase::getLatencySamples(eqParameters.getFirLength());
+
+    return oversampling.getLatencySamples(eqParameters.getOversamplingOrder(), eqParameters.isOversamplingFilterLinearPhase());
+}
+
+double AudioPluginAudioProcessor::getTailSamples(double sampleRate) const noexcept
+{
+    if (isLinearPhaseLoaded())
+        return (double) eqParameters.getFirLength();
+
+    auto samples = 0.0;
+
+    for (int i = 0; i < EqParameters::numBands; ++i)
+    {
+        auto &band = eqParameters.getBand(i);
+
+        if (band.on->load() < 0.5f)
+            continue;
+
+        auto type = (FilterType) juce::jlimit(0, (int) EqFilterDesign::lastFilterType, juce::roundToInt(band.type->load()));
+        auto ringOut = EqFilterDesign::getRingOutSamples(type, sampleRate, band.freq->load(), band.q->load(), band.gain->load(),
+                                                         -silenceDecibels);
+
+        // Une bande dynamique passe par tous les gains entre 0 dB et le sien : une coupure résonne plus près de 0 dB
+        if (band.dynamic->load() >= 0.5f && EqFilterDesign::hasGain(type))
+            ringOut = juce::jmax(ringOut, EqFilterDesign::getRingOutSamples(type, sampleRate, band.freq->load(), band.q->load(),
+                                                                            0.0f, -silenceDecibels));
 
-    eq1Filter.prepare(spec);
-    eq1Filter.reset();
-    eq2Filter.prepare(spec);
-    eq2Filter.reset();
+        samples += ringOut;
+    }
+
+    // Les filtres de suréchantillonnage s'étalent de part et d'autre de leur latence
+    return samples + 2.0 * oversampling.getLatencySamples(eqParameters.getOversamplingOrder(),
+                                                          eqParameters.isOversamplingFilterLinearPhase());
+}
 
-    updateFilters();
+// Peut venir du thread audio (automation) : la notification de l'hôte est reportée au thread de messages
+void AudioPluginAudioProcessor::parameterChanged(const juce::String &, float)
+{
+    latencyDirty.store(true, std::memory_order_release);
+}
+
+void AudioPluginAudioProcessor::timerCallback()
+{
+    if (latencyDirty.exchange(false, std::memory_order_acquire))
+    {
+        linearPhase.setEnabled(eqParameters.isLinearPhase());
+        setLatencySamples(getCurrentLatency());
+    }
 }
 
 void AudioPluginAudioProcessor::releaseResources()
@@ -125,13 +222,26 @@ bool AudioPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
     juce::ignoreUnused (layouts);
     return true;
   #else
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // N'importe quelle disposition de 1 à maxNumChannels canaux : les canaux sont traités par
+    // paires dans les voies SIMD, sans dépendre de leur rôle. Aucune allocation ici, l'hôte
+    // peut interroger autant de dispositions qu'il veut : seul prepareToPlay dimensionne l'état
+    auto mainOutput = layouts.getMainOutputChannelSet();
+
+    if (mainOutput.isDisabled() || mainOutput.size() > maxNumChannels)
         return false;
 
     #if ! JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
         return false;
+
+    // Sidechain facultatif, mono ou stéréo
+    if (layouts.inputBuses.size() > 1)
+    {
+        auto sidechain = layouts.getChannelSet(true, 1);
+
+        if (! sidechain.isDisabled() && sidechain != juce::AudioChannelSet::mono() && sidechain != juce::AudioChannelSet::stereo())
+            return false;
+    }
     #endif
 
     return true;
@@ -142,7 +252,25 @@ bool AudioPluginAudioProcessor::isBusesLayoutSupported (const BusesLayout& layou
 void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ignoreUnused (midiMessages);
+    processWithEngine(buffer, floatEngine);
+}
+
+void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused (midiMessages);
+    processWithEngine(buffer, doubleEngine);
+}
+
+bool AudioPluginAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+    return true;
+}
 
+template <typename SampleType, typename EngineType>
+void AudioPluginAudioProcessor::processWithEngine(juce::AudioBuffer<SampleType> &buffer, EngineType &engine)
+{
+    EqRealtimeGuard::ScopedAudioCallback audioCallback;
+    EqLoadMonitor::ScopedTimer loadTimer(loadMonitor, buffer.getNumSamples());
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -150,18 +278,105 @@ void AudioPluginAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    updateFilters();
+    // Changements reçus par OSC depuis le bloc précédent, avant la lecture des paramètres
+    oscServer.processPendingMessages();
+
+    // Le tampon porte aussi les canaux du sidechain, après ceux de l'entrée principale. Un hôte qui
+    // change de disposition sans rappeler prepareToPlay voit ses canaux en trop passer sans traitement
+    juce::dsp::AudioBlock<SampleType> fullBlock(buffer);
+    auto block = fullBlock.getSubsetChannelBlock(0, (size_t) juce::jmin(getMainBusNumInputChannels(), preparedNumChannels));
+    juce::dsp::AudioBlock<SampleType> sidechain;
+
+    if (auto *sidechainBus = getBus(true, 1); sidechainBus != nullptr && sidechainBus->isEnabled())
+        sidechain = fullBlock.getSubsetChannelBlock((size_t) getChannelIndexInProcessBlockBuffer(true, 1, 0),
+                                                    (size_t) sidechainBus->getNumberOfChannels());
+
+    analyser.pushPre(block);
+
+    // Entrée silencieuse depuis plus longtemps que la résonance des filtres : la sortie est sous le seuil
+    // du silence, elle est mise à zéro sans aucun calcul jusqu'au retour du signal
+    auto inputSilent = isSilent(block, (SampleType) juce::Decibels::decibelsToGain(silenceDecibels));
+
+    if (! inputSilent)
+    {
+        // Les détecteurs n'ont pas tourné pendant la pause : leur enveloppe est périmée
+        if (idle)
+            dynamics.reset();
+
+        idle = false;
+        silentSamples = 0;
+    }
+
+    outputSilent.store(idle, std::memory_order_relaxed);
+
+    if (idle)
+    {
+        block.clear();
+        analyser.pushPost(block);
+        return;
+    }
+
+    // Le changement de mode change la latence : pas de fondu possible entre les deux, l'historique
+    // de la convolution est simplement vidé pour ne pas rejouer un signal ancien
+    if (isLinearPhaseLoaded())
+    {
+        if (! linearPhaseActive)
+            linearPhase.reset();
+
+        linearPhaseActive = true;
+        linearPhase.process(block);
+    }
+    else
+    {
+        // Les détecteurs n'ont pas tourné en phase linéaire : leur enveloppe est périmée
+        if (linearPhaseActive)
+            dynamics.reset();
+
+        linearPhaseActive = false;
+
+        // Avant la cascade, sur le signal pas encore égalisé
+        dynamics.process(block, sidechain);
+        processMinimumPhase(block, engine);
+    }
+
+    analyser.pushPost(block);
+
+    // Durée de résonance recalculée seulement pendant le silence, avant la mise en pause
+    if (inputSilent)
+    {
+        silentSamples += (juce::int64) block.getNumSamples();
+        idle = (double) silentSamples >= getTailSamples(hostSampleRate.load(std::memory_order_relaxed));
+    }
+}
 
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
+template <typename SampleType, typename EngineType>
+void AudioPluginAudioProcessor::processMinimumPhase(juce::dsp::AudioBlock<SampleType> &block, EngineType &engine)
+{
+    auto order = eqParameters.getOversamplingOrder();
+    auto linearPhaseFilters = eqParameters.isOversamplingFilterLinearPhase();
 
-    bool eq1On = parameters.getRawParameterValue("EQ1_ON")->load();
-    if (eq1On)
-        eq1Filter.process(context);
+    // Comme pour le mode de phase, la latence change : pas de fondu, les filtres repartent de zéro
+    if (order != oversamplingOrder || linearPhaseFilters != oversamplingLinearPhase)
+    {
+        if (order != oversamplingOrder)
+            engine.setSampleRate(hostSampleRate.load(std::memory_order_relaxed) * (1 << order));
+
+        oversampling.reset();
+        oversamplingOrder = order;
+        oversamplingLinearPhase = linearPhaseFilters;
+    }
+
+    if (order == 0)
+    {
+        engine.process(block, &dynamics);
+        return;
+    }
 
-    bool eq2On = parameters.getRawParameterValue("EQ2_ON")->load();
-    if (eq2On)
-        eq2Filter.process(context);
+    // Un seul aller-retour pour toutes les bandes
+    auto &stage = oversampling.getStage<SampleType>(order, linearPhaseFilters);
+    auto oversampledBlock = stage.processSamplesUp(block);
+    engine.process(oversampledBlock, &dynamics);
+    stage.processSamplesDown(block);
 }
 
 //==============================================================================
@@ -178,21 +393,25 @@ juce::AudioProcessorEditor* AudioPluginAudioProcessor::createEditor()
 //==============================================================================
 void AudioPluginAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // Sauvegarde de l'état des paramètres
-    auto state = parameters.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    // Sauvegarde de l'état des paramètres, au format binaire (EqStateFormat)
+    stateFormat.write(destData);
 }
 
 void AudioPluginAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // Restaure l'état des paramètres
+    // Restaure l'état des paramètres : format binaire, ou XML des versions précédentes
+    if (EqStateFormat::isBinaryState(data, sizeInBytes))
+    {
+        stateFormat.read(data, sizeInBytes);
+        return;
+    }
+
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
 
     if (xmlState && xmlState->hasTagName(parameters.state.getType()))
     {
+        // Les nouveaux coefficients seront calculés au prochain bloc audio
         parameters.replaceState(juce::ValueTree::fromXml(*xmlState));
-        updateFilters();
     }
 }
 
@@ -201,35 +420,3 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
     return new AudioPluginAudioProcessor();
 }
-
-// Mise à jour des filtres EQ en fonction des paramètres
-void AudioPluginAudioProcessor::updateFilters()
-{
-    // EQ1
-    auto eq1Freq = parameters.getRawParameterValue("EQ1_FREQ")->load();
-    auto eq1Gain = parameters.getRawParameterValue("EQ1_GAIN")->load();
-    auto eq1Q = parameters.getRawParameterValue("EQ1_Q")->load();
-    bool eq1On = parameters.getRawParameterValue("EQ1_ON")->load();
-
-    if (eq1On) {
-        auto newCoefficients = juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-            getSampleRate(), eq1Freq, eq1Q, juce::Decibels::decibelsToGain(eq1Gain));
-        *eq1Filter.state = *newCoefficients;
-    } else {
-        eq1Filter.reset();
-    }
-
-    // EQ2
-    auto eq2Freq = parameters.getRawParameterValue("EQ2_FREQ")->load();
-    auto eq2Gain = parameters.getRawParameterValue("EQ2_GAIN")->load();
-    auto eq2Q = parameters.getRawParameterValue("EQ2_Q")->load();
-    bool eq2On = parameters.getRawParameterValue("EQ2_ON")->load();
-
-    if (eq2On) {
-        auto newCoefficients = juce::dsp::IIR::Coefficients<float>::makePeakFilter(
-            getSampleRate(), eq2Freq, eq2Q, juce::Decibels::decibelsToGain(eq2Gain));
-        *eq2Filter.state = *newCoefficients;
-    } else {
-        eq2Filter.reset();
-    }
-}
@@ -2,11 +2,32 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
+#include "EqDynamics.h"
+#include "EqEngine.h"
+#include "EqLinearPhase.h"
+#include "EqLoadMonitor.h"
+#include "EqOscServer.h"
+#include "EqOversampling.h"
+#include "EqParameters.h"
+#include "EqRealtimeGuard.h"
+#include "EqSpectrumAnalyser.h"
+#include "EqStateFormat.h"
+
+// 1 pour que le chemin float garde l'état et les coefficients des filtres en double
+// (entrées et sorties restent en float) ; le chemin double est toujours en double
+#ifndef SDPEQ_DOUBLE_PRECISION_STATE
+ #define SDPEQ_DOUBLE_PRECISION_STATE 0
+#endif
 
 //==============================================================================
-class AudioPluginAudioProcessor : public juce::AudioProcessor
+class AudioPluginAudioProcessor : public juce::AudioProcessor,
+                                  private juce::AudioProcessorValueTreeState::Listener,
+                                  private juce::Timer
 {
 public:
+    // Canaux du bus principal : de mono à 16 canaux discrets (quad, 5.1, 7.1, matrices de diffusion)
+    static constexpr int maxNumChannels = 16;
+
     //==============================================================================
     AudioPluginAudioProcessor();
 
@@ -23,7 +44,9 @@ public:
 
     void processBlock(juce::AudioBuffer<float> &, juce::MidiBuffer &) override;
 
-    using AudioProcessor::processBlock;
+    void processBlock(juce::AudioBuffer<double> &, juce::MidiBuffer &) override;
+
+    bool supportsDoublePrecisionProcessing() const override;
 
     //==============================================================================
     juce::AudioProcessorEditor *createEditor() override;
@@ -59,24 +82,89 @@ public:
 
     juce::AudioProcessorValueTreeState &getValueTreeState() { return parameters; }
 
-    template<typename ValueT>
-    juce::NormalisableRange<ValueT> logRange(ValueT min, ValueT max)
-    {
-        ValueT rng{std::log(max / min)};
-        return {
-            min, max,
-            [=](ValueT min, ValueT, ValueT v) { return std::exp(v * rng) * min; },
-            [=](ValueT min, ValueT, ValueT v) { return std::log(v / min) / rng; }
-        };
-    }
+    EqOscServer &getOscServer() { return oscServer; }
+
+    EqSpectrumAnalyser &getAnalyser() { return analyser; }
+
+    EqParameters &getEqParameters() { return eqParameters; }
+
+    EqLoadMonitor &getLoadMonitor() { return loadMonitor; }
+
+    // Vrai quand le dernier bloc a été sauté (entrée silencieuse, filtres éteints) : sa sortie est à zéro exact
+    bool isOutputSilent() const noexcept { return outputSilent.load(std::memory_order_relaxed); }
 
 private:
     juce::AudioProcessorValueTreeState parameters;
+    EqParameters eqParameters { parameters };
+    EqOscServer oscServer { eqParameters, parameters };
+
+    // Format binaire de getStateInformation ; les anciens états XML restent lisibles
+    EqStateFormat stateFormat { parameters };
+
+    // Durée de chaque bloc ; détruit avant oscServer, qui publie ses statistiques
+    EqLoadMonitor loadMonitor;
+
+    // Précision de l'état des filtres pour les blocs float
+    using FloatPathSampleType = std::conditional_t<SDPEQ_DOUBLE_PRECISION_STATE != 0, double, float>;
+
+    EqEngine<FloatPathSampleType, EqParameters::numBands> floatEngine { eqParameters };
+    EqEngine<double, EqParameters::numBands> doubleEngine { eqParameters };
+
+    // Utilisé à la place des moteurs quand PHASE_MODE est "Linear Phase", pour les deux précisions
+    EqLinearPhase linearPhase { eqParameters };
+    bool linearPhaseActive = false;
+
+    // Suréchantillonnage du mode phase minimale, réglage appliqué au moteur et fréquence de l'hôte (aussi lue
+    // depuis le thread de messages par getTailLengthSeconds())
+    EqOversampling oversampling;
+    std::atomic<double> hostSampleRate { 44100.0 };
+    int oversamplingOrder = 0;
+    bool oversamplingLinearPhase = false;
+
+    // Détecteurs des bandes dynamiques, à la fréquence de l'hôte, sur l'entrée ou le sidechain
+    EqDynamics dynamics { eqParameters };
+
+    // Canaux du bus principal au dernier prepareToPlay : tout l'état est dimensionné pour eux
+    int preparedNumChannels = 0;
+
+    // Seuil du silence : entrée sous ce niveau, et résonance des filtres jusqu'à ce niveau
+    static constexpr float silenceDecibels = -120.0f;
+
+    // Echantillons d'entrée silencieux consécutifs, et traitement suspendu une fois la résonance terminée
+    juce::int64 silentSamples = 0;
+    bool idle = false;
+    std::atomic<bool> outputSilent { false };
+
+    // Spectre avant et après l'EQ, affiché par l'interface ; inactif quand elle est fermée
+    EqSpectrumAnalyser analyser;
+
+    // Phase linéaire choisie et son premier FIR chargé : jusque-là, la cascade reste en place
+    bool isLinearPhaseLoaded() const noexcept { return eqParameters.isLinearPhase() && linearPhase.isLoaded(); }
+
+    // Latence du mode de phase courant, en échantillons
+    int getCurrentLatency() const noexcept;
+
+    // Durée de résonance des réglages courants à sampleRate, en échantillons : bandes actives mises bout à
+    // bout, filtres de suréchantillonnage, ou longueur du FIR en phase linéaire ; sans allocation
+    double getTailSamples(double sampleRate) const noexcept;
+
+    // PHASE_MODE, FIR_LENGTH, OVERSAMPLING et OVERSAMPLING_FILTER changent la latence : elle est rapportée à l'hôte depuis le thread de messages
+    void parameterChanged(const juce::String &parameterID, float newValue) override;
+
+    // Thread de messages : quand latencyDirty est levé, charge ou arrête la phase linéaire, puis rapporte la latence à l'hôte
+    void timerCallback() override;
+
+    // Levé par parameterChanged, qui peut venir du thread audio : ni verrou, ni allocation, ni appel système
+    std::atomic<bool> latencyDirty { false };
+
+    static constexpr int latencyPollRateHz = 20;
 
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>> eq1Filter;
-    juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>> eq2Filter;
+    template <typename SampleType, typename EngineType>
+    void processWithEngine(juce::AudioBuffer<SampleType> &buffer, EngineType &engine);
 
-    void updateFilters();
+    // Mode phase minimale : la cascade, suréchantillonnée ou non
+    template <typename SampleType, typename EngineType>
+    void processMinimumPhase(juce::dsp::AudioBlock<SampleType> &block, EngineType &engine);
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioPluginAudioProcessor)
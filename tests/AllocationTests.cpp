@@ -0,0 +1,153 @@
+#include "AllocationCounter.h"
+#include "TestUtilities.h"
+
+//==============================================================================
+/*  processBlock ne doit jamais allouer : operator new, et malloc sous Linux, sont comptés sur
+    le thread du test pendant chaque appel (AllocationCounter), après quelques blocs de mise
+    en route. Un premier test vérifie que le compteur voit bien ces allocations. Les
+    réglages couvrent les deux précisions, l'automation continue, la phase linéaire (FIR
+    recalculés et rechargés pendant le balayage), le suréchantillonnage et le mode dynamique
+    avec sidechain.
+*/
+class AllocationTests : public juce::UnitTest
+{
+public:
+    AllocationTests() : juce::UnitTest("processBlock allocations", "SimpleDualParametricEq") {}
+
+    void runTest() override
+    {
+        using Field = EqParameters::BandField;
+
+        struct Case
+        {
+            const char *name;
+            bool sweep = false;
+            bool sidechain = false;
+            std::function<void(AudioPluginAudioProcessor &)> configure;
+        };
+
+        const std::vector<Case> cases {
+            { "static", false, false, [](AudioPluginAudioProcessor &) {} },
+            { "sweep", true, false, [](AudioPluginAudioProcessor &) {} },
+            { "linear phase, sweep", true, false,
+              [](AudioPluginAudioProcessor &p) { TestUtilities::setParameter(p, "PHASE_MODE", 1.0f); } },
+            { "oversampling 2x, sweep", true, false,
+              [](AudioPluginAudioProcessor &p) { TestUtilities::setParameter(p, "OVERSAMPLING", 1.0f); } },
+            { "oversampling 4x linear-phase filters", false, false,
+              [](AudioPluginAudioProcessor &p)
+              {
+                  TestUtilities::setParameter(p, "OVERSAMPLING", 2.0f);
+                  TestUtilities::setParameter(p, "OVERSAMPLING_FILTER", 1.0f);
+              } },
+            { "dynamic bands, sidechain, sweep", true, true,
+              [](AudioPluginAudioProcessor &p)
+              {
+                  for (int band = 0; band < EqParameters::numBands; ++band)
+                  {
+                      TestUtilities::setBandParameter(p, band, Field::dynamic, 1.0f);
+                      TestUtilities::setBandParameter(p, band, Field::threshold, -40.0f);
+                      TestUtilities::setBandParameter(p, band, Field::sidechain, band == 0 ? 1.0f : 0.0f);
+                  }
+              } }
+        };
+
+        beginTest("counter sees operator new and malloc");
+        checkCounter();
+
+        for (auto &testCase : cases)
+        {
+            for (auto doublePrecision : { false, true })
+            {
+                beginTest(juce::String(testCase.name) + (doublePrecision ? ", double" : ", float"));
+
+                if (doublePrecision)
+                    expectEquals(countAllocations<double>(testCase.configure, testCase.sweep, testCase.sidechain), (juce::int64) 0);
+                else
+                    expectEquals(countAllocations<float>(testCase.configure, testCase.sweep, testCase.sidechain), (juce::int64) 0);
+            }
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 256;
+    static constexpr int warmupBlocks = 16;
+    static constexpr int numBlocks = 200;
+
+    // Pause laissée régulièrement aux threads de fond (conception des FIR, moteurs de Convolution)
+    static constexpr int pauseInterval = 20;
+    static constexpr int pauseMilliseconds = 40;
+
+    // Les allocations restent en vie après stop() et sont utilisées : le compilateur ne peut pas les retirer. Le compte
+    // est lu avant de construire les messages (String alloue)
+    void checkCounter()
+    {
+        std::unique_ptr<int> object;
+
+        AllocationCounter::start();
+        object = std::make_unique<int>(1);
+        auto newAllocations = AllocationCounter::stop();
+
+        expectEquals(newAllocations, (juce::int64) 1, "operator new not counted");
+        expectEquals(*object, 1);
+
+        if (! AllocationCounter::isCountingMalloc())
+            return;
+
+        juce::HeapBlock<float> heapBlock;
+
+        AllocationCounter::start();
+        heapBlock.calloc(64);
+        heapBlock.realloc(128);
+        auto mallocAllocations = AllocationCounter::stop();
+
+        expectEquals(mallocAllocations, (juce::int64) 2, "HeapBlock calloc / realloc not counted");
+        expectEquals(heapBlock[0], 0.0f);
+    }
+
+    template <typename SampleType>
+    juce::int64 countAllocations(const std::function<void(AudioPluginAudioProcessor &)> &configure, bool sweep, bool sidechain)
+    {
+        AudioPluginAudioProcessor processor;
+        configure(processor);
+
+        if (! TestUtilities::prepare(processor, sampleRate, blockSize, std::is_same_v<SampleType, double>, 2, sidechain))
+        {
+            expect(false, "layout refused");
+            return -1;
+        }
+
+        juce::AudioBuffer<SampleType> buffer(processor.getTotalNumInputChannels(), blockSize);
+        juce::MidiBuffer midi;
+        juce::Random random(1);
+        juce::int64 allocations = 0;
+
+        for (int block = 0; block < warmupBlocks + numBlocks; ++block)
+        {
+            // Automation appliquée entre deux blocs, comme par l'hôte
+            if (sweep)
+            {
+                auto phase = (double) block / (double) (warmupBlocks + numBlocks);
+                TestUtilities::setParameter(processor, "EQ1_FREQ", (float) (100.0 * std::pow(10.0, 1.5 * phase)));
+                TestUtilities::setParameter(processor, "EQ2_GAIN", (float) (12.0 * std::sin(juce::MathConstants<double>::twoPi * 4.0 * phase)));
+            }
+
+            if (block % pauseInterval == 0)
+                juce::Thread::sleep(pauseMilliseconds);
+
+            TestUtilities::fillWithNoise(buffer, random);
+
+            AllocationCounter::start();
+            processor.processBlock(buffer, midi);
+            auto blockAllocations = AllocationCounter::stop();
+
+            if (block >= warmupBlocks)
+                allocations += blockAllocations;
+        }
+
+        processor.releaseResources();
+        return allocations;
+    }
+};
+
+static AllocationTests allocationTests;
@@ -0,0 +1,86 @@
+#include <complex>
+#include "TestUtilities.h"
+
+//==============================================================================
+/*  Cloche bilinéaire contre cloche "matched" : écart maximal (dB) avec la cloche analogique
+    entre 10 Hz et Nyquist, pour chaque fréquence centrale, sur une grille de gains
+    (+-3, 12, 24 dB) et de Q (0,5 à 10), à 44,1, 48 et 96 kHz.
+
+    La cloche "matched" ne doit jamais s'écarter plus que la bilinéaire, et reste sous
+    maxMatchedDeviationDecibels tant que la fréquence centrale est sous 10 kHz (au-delà,
+    une cellule du second ordre ne peut plus suivre la cloche analogique jusqu'à Nyquist).
+*/
+class BellDesignTests : public juce::UnitTest
+{
+public:
+    BellDesignTests() : juce::UnitTest("Bell design deviation", "SimpleDualParametricEq") {}
+
+    void runTest() override
+    {
+        const double centreFrequencies[] = { 1000.0, 2000.0, 5000.0, 10000.0, 15000.0, 20000.0 };
+
+        for (auto sampleRate : { 44100.0, 48000.0, 96000.0 })
+        {
+            beginTest(juce::String(sampleRate / 1000.0, 1) + " kHz");
+
+            for (auto centre : centreFrequencies)
+            {
+                auto bilinear = getMaximumDeviation(FilterType::bell, sampleRate, centre);
+                auto matched = getMaximumDeviation(FilterType::bellMatched, sampleRate, centre);
+                auto where = " at fc = " + juce::String(centre) + " Hz";
+
+                logMessage("fc " + juce::String(centre / 1000.0, 0).paddedLeft(' ', 2) + "k   bilinear "
+                           + juce::String(bilinear, 2).paddedLeft(' ', 6) + " dB   matched " + juce::String(matched, 2).paddedLeft(' ', 5) + " dB");
+
+                expectLessOrEqual(matched, bilinear, "matched deviation above bilinear" + where);
+
+                if (centre < 10000.0)
+                    expectLessOrEqual(matched, maxMatchedDeviationDecibels, "matched deviation above ceiling" + where);
+            }
+        }
+    }
+
+private:
+    // Pire cas de la grille (Q de 10, +-24 dB) à 5 kHz et 44,1 kHz : environ 3 dB
+    static constexpr double maxMatchedDeviationDecibels = 3.5;
+
+    static double analogDecibels(double frequency, double centre, double gainDecibels, double q)
+    {
+        auto A = std::pow(10.0, gainDecibels / 40.0);
+        auto s = std::complex<double>(0.0, frequency / centre);
+        return 20.0 * std::log10(std::abs((s * s + s * (A / q) + 1.0) / (s * s + s / (A * q) + 1.0)));
+    }
+
+    static double digitalDecibels(const BiquadCoefficients<double> &c, double frequency, double sampleRate)
+    {
+        auto z1 = std::polar(1.0, -juce::MathConstants<double>::twoPi * frequency / sampleRate);
+        auto z2 = z1 * z1;
+        return 20.0 * std::log10(std::abs((c.b0 + c.b1 * z1 + c.b2 * z2) / (1.0 + c.a1 * z1 + c.a2 * z2)));
+    }
+
+    static double getMaximumDeviation(FilterType type, double sampleRate, double centre)
+    {
+        const double gains[] = { -24.0, -12.0, -3.0, 3.0, 12.0, 24.0 };
+        const double qs[] = { 0.5, 1.0, 3.0, 10.0 };
+        auto worst = 0.0;
+
+        for (auto gain : gains)
+        {
+            for (auto q : qs)
+            {
+                BiquadCoefficients<double> c;
+                EqFilterDesign::design<double>(type, sampleRate, (float) centre, (float) q, (float) gain, &c);
+
+                for (int i = 0; i < 400; ++i)
+                {
+                    auto frequency = 10.0 * std::pow(sampleRate / 20.0, i / 399.0) * 0.9999;
+                    worst = juce::jmax(worst, std::abs(digitalDecibels(c, frequency, sampleRate) - analogDecibels(frequency, centre, gain, q)));
+                }
+            }
+        }
+
+        return worst;
+    }
+};
+
+static BellDesignTests bellDesignTests;
@@ -0,0 +1,247 @@
+#include "TestUtilities.h"
+
+//==============================================================================
+/*  Kill switch d'une bande (EQn_ON) sur une sinusoïde plus une composante continue : le plus
+    grand écart entre deux échantillons consécutifs de la sortie reste sous une borne, avec le
+    fondu par défaut (10 ms) comme sans fondu.
+
+    Un changement de structure (EQn_TOPOLOGY, automatisable) passe par le même fondu, la
+    nouvelle structure partant du régime permanent : même borne.
+
+    Un changement de durée pendant un fondu (BYPASS_FADE est automatisable) ne termine pas le
+    fondu d'un coup : la rampe continue depuis sa valeur courante, à la nouvelle durée.
+
+    La borne est tirée de deux rendus de référence (bande toujours active, toujours contournée) :
+    la pente propre du signal, plus l'écart entre signal filtré et signal direct réparti sur la
+    durée du fondu. Sans fondu, l'écart passe en un échantillon mais rien ne s'y ajoute (état
+    initialisé au régime permanent, pas de transitoire de remise à zéro).
+
+    Une bande dynamique coupée garde le dernier gain de son détecteur pendant son fondu : le
+    niveau de sortie passe du niveau comprimé au niveau direct sans plonger vers la
+    profondeur maximale de la bande.
+*/
+class BypassFadeTests : public juce::UnitTest
+{
+public:
+    BypassFadeTests() : juce::UnitTest("Bypass fade discontinuity", "SimpleDualParametricEq") {}
+
+    void runTest() override
+    {
+        for (auto fadeMilliseconds : { 10.0f, 0.0f })
+        {
+            beginTest("fade " + juce::String(fadeMilliseconds) + " ms, float");
+            checkDiscontinuity<float>(fadeMilliseconds);
+
+            beginTest("fade " + juce::String(fadeMilliseconds) + " ms, double");
+            checkDiscontinuity<double>(fadeMilliseconds);
+        }
+
+        beginTest("topology switched, float");
+        checkDiscontinuity<float>(10.0f, 0.0f, EqParameters::BandField::topology);
+
+        beginTest("topology switched, double");
+        checkDiscontinuity<double>(10.0f, 0.0f, EqParameters::BandField::topology);
+
+        beginTest("fade time changed during a fade, float");
+        checkDiscontinuity<float>(10.0f, 50.0f);
+
+        beginTest("fade time changed during a fade, double");
+        checkDiscontinuity<double>(10.0f, 50.0f);
+
+        beginTest("dynamic band switched off, float");
+        checkDynamicFadeOut<float>();
+
+        beginTest("dynamic band switched off, double");
+        checkDynamicFadeOut<double>();
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 256;
+    static constexpr int numBlocks = 160;
+
+    // Le début du rendu (mise en route des filtres) n'est pas mesuré
+    static constexpr int warmupBlocks = 8;
+
+    static constexpr double sineFrequency = 100.0;
+    static constexpr double sineAmplitude = 0.25;
+    static constexpr double dcOffset = 0.25;
+
+    // Bascules espacées de plus d'un fondu, puis une bascule en plein fondu de sortie (bloc 151)
+    static bool isBandOn(int block) noexcept
+    {
+        return block < 40 || (block >= 80 && block < 120) || (block >= 140 && block != 150);
+    }
+
+    // Bloc où changedFadeMilliseconds (s'il est positif) remplace la durée : en plein fondu de la bascule du bloc 40
+    static constexpr int fadeChangeBlock = 41;
+
+    // toggledField passe de 1 à 0 et inversement selon bandOn : la bande elle-même (on), ou sa structure (topology)
+    template <typename SampleType>
+    std::vector<double> render(float fadeMilliseconds, float changedFadeMilliseconds, EqParameters::BandField toggledField,
+                               const std::function<bool(int)> &bandOn)
+    {
+        AudioPluginAudioProcessor processor;
+
+        // Plateau grave de +6 dB : la sinusoïde et la composante continue sont presque doublées
+        TestUtilities::setBandParameter(processor, 0, EqParameters::BandField::type, (float) FilterType::lowShelf);
+        TestUtilities::setBandParameter(processor, 0, EqParameters::BandField::freq, 1000.0f);
+        TestUtilities::setBandParameter(processor, 0, EqParameters::BandField::gain, 6.0f);
+        TestUtilities::setBandParameter(processor, 0, EqParameters::BandField::q, 0.707f);
+        TestUtilities::setBandParameter(processor, 0, toggledField, bandOn(0) ? 1.0f : 0.0f);
+        TestUtilities::setParameter(processor, "BYPASS_FADE", fadeMilliseconds);
+
+        std::vector<double> output;
+
+        if (! TestUtilities::prepare(processor, sampleRate, blockSize, std::is_same_v<SampleType, double>))
+        {
+            expect(false, "layout refused");
+            return output;
+        }
+
+        juce::AudioBuffer<SampleType> buffer(processor.getTotalNumInputChannels(), blockSize);
+        juce::MidiBuffer midi;
+        auto increment = juce::MathConstants<double>::twoPi * sineFrequency / sampleRate;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            TestUtilities::setBandParameter(processor, 0, toggledField, bandOn(block) ? 1.0f : 0.0f);
+
+            if (block == fadeChangeBlock && changedFadeMilliseconds > 0.0f)
+                TestUtilities::setParameter(processor, "BYPASS_FADE", changedFadeMilliseconds);
+
+            for (int i = 0; i < blockSize; ++i)
+            {
+                auto sample = dcOffset + sineAmplitude * std::sin(increment * (double) (block * blockSize + i));
+
+                for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                    buffer.setSample(channel, i, (SampleType) sample);
+            }
+
+            processor.processBlock(buffer, midi);
+
+            for (int i = 0; i < blockSize; ++i)
+                output.push_back((double) buffer.getSample(0, i));
+        }
+
+        processor.releaseResources();
+        return output;
+    }
+
+    static double getMaximumStep(const std::vector<double> &signal) noexcept
+    {
+        double maximum = 0.0;
+
+        for (size_t i = (size_t) (warmupBlocks * blockSize) + 1; i < signal.size(); ++i)
+            maximum = juce::jmax(maximum, std::abs(signal[i] - signal[i - 1]));
+
+        return maximum;
+    }
+
+    // La borne suit la plus courte des deux durées de fondu
+    template <typename SampleType>
+    void checkDiscontinuity(float fadeMilliseconds, float changedFadeMilliseconds = 0.0f,
+                            EqParameters::BandField toggledField = EqParameters::BandField::on)
+    {
+        using Field = EqParameters::BandField;
+
+        auto wet = render<SampleType>(fadeMilliseconds, changedFadeMilliseconds, Field::on, [](int) { return true; });
+        auto dry = render<SampleType>(fadeMilliseconds, changedFadeMilliseconds, Field::on, [](int) { return false; });
+        auto toggled = render<SampleType>(fadeMilliseconds, changedFadeMilliseconds, toggledField, isBandOn);
+
+        if (wet.empty() || wet.size() != dry.size() || wet.size() != toggled.size())
+            return;
+
+        double gap = 0.0;
+
+        for (size_t i = (size_t) (warmupBlocks * blockSize); i < wet.size(); ++i)
+            gap = juce::jmax(gap, std::abs(wet[i] - dry[i]));
+
+        auto naturalStep = juce::jmax(getMaximumStep(wet), getMaximumStep(dry));
+        auto fadeSamples = juce::jmax(1.0, (double) fadeMilliseconds * 0.001 * sampleRate);
+        auto bound = 1.1 * (naturalStep + gap / fadeSamples);
+
+        // Le signal doit rendre une bascule sans fondu visible, sinon le test ne prouve rien
+        if (fadeMilliseconds > 0.0f)
+            expectGreaterThan(gap, 10.0 * bound);
+
+        auto step = getMaximumStep(toggled);
+        expectLessOrEqual(step, bound, "largest step " + juce::String(step) + ", bound " + juce::String(bound));
+    }
+
+    /*  Cloche dynamique de -24 dB à 1 kHz sur une sinusoïde de 1 kHz à -6 dBFS : le détecteur ne
+        coupe qu'une dizaine de dB (seuil -30 dB, taux 2). La crête de chaque période pendant le
+        fondu de 50 ms ne doit pas descendre sous celle d'avant la coupure.
+    */
+    template <typename SampleType>
+    void checkDynamicFadeOut()
+    {
+        using Field = EqParameters::BandField;
+        constexpr int switchBlock = 40;
+        constexpr int period = 48; // 1 kHz à 48 kHz
+
+        AudioPluginAudioProcessor processor;
+        TestUtilities::setBandParameter(processor, 0, Field::freq, 1000.0f);
+        TestUtilities::setBandParameter(processor, 0, Field::gain, -24.0f);
+        TestUtilities::setBandParameter(processor, 0, Field::dynamic, 1.0f);
+        TestUtilities::setBandParameter(processor, 0, Field::threshold, -30.0f);
+        TestUtilities::setBandParameter(processor, 0, Field::ratio, 2.0f);
+        TestUtilities::setParameter(processor, "BYPASS_FADE", 50.0f);
+
+        if (! TestUtilities::prepare(processor, sampleRate, blockSize, std::is_same_v<SampleType, double>))
+        {
+            expect(false, "layout refused");
+            return;
+        }
+
+        juce::AudioBuffer<SampleType> buffer(processor.getTotalNumInputChannels(), blockSize);
+        juce::MidiBuffer midi;
+        std::vector<double> output;
+
+        for (int block = 0; block < switchBlock + 20; ++block)
+        {
+            if (block == switchBlock)
+                TestUtilities::setBandParameter(processor, 0, Field::on, 0.0f);
+
+            for (int i = 0; i < blockSize; ++i)
+            {
+                auto sample = 0.5 * std::sin(juce::MathConstants<double>::twoPi * (double) ((block * blockSize + i) % period) / (double) period);
+
+                for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                    buffer.setSample(channel, i, (SampleType) sample);
+            }
+
+            processor.processBlock(buffer, midi);
+
+            for (int i = 0; i < blockSize; ++i)
+                output.push_back((double) buffer.getSample(0, i));
+        }
+
+        processor.releaseResources();
+
+        auto getPeak = [&](size_t start)
+        {
+            double peak = 0.0;
+
+            for (size_t i = start; i < start + (size_t) period; ++i)
+                peak = juce::jmax(peak, std::abs(output[i]));
+
+            return peak;
+        };
+
+        auto switchSample = (size_t) (switchBlock * blockSize);
+        auto compressedPeak = getPeak(switchSample - (size_t) period);
+        auto lowestPeak = compressedPeak;
+
+        // Le détecteur doit vraiment couper moins que la profondeur de la bande, sinon le test ne prouve rien
+        expectGreaterThan(juce::Decibels::gainToDecibels(compressedPeak / 0.5), -18.0);
+
+        for (auto start = switchSample; start + (size_t) period <= output.size(); start += (size_t) period)
+            lowestPeak = juce::jmin(lowestPeak, getPeak(start));
+
+        expectGreaterOrEqual(juce::Decibels::gainToDecibels(lowestPeak / compressedPeak), -0.5,
+                             "peak fell to " + juce::String(juce::Decibels::gainToDecibels(lowestPeak / 0.5), 1) + " dB during the fade");
+    }
+};
+
+static BypassFadeTests bypassFadeTests;
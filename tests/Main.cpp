@@ -0,0 +1,22 @@
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+
+//==============================================================================
+/*  Tests du plugin : les juce::UnitTest de la catégorie "SimpleDualParametricEq", déclarés
+    dans les autres fichiers de ce dossier. Code de sortie non nul au premier échec, pour ctest.
+*/
+int main()
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    runner.runTestsInCategory("SimpleDualParametricEq");
+
+    int numFailures = 0;
+
+    for (int i = 0; i < runner.getNumResults(); ++i)
+        numFailures += runner.getResult(i)->failures;
+
+    return numFailures > 0 ? 1 : 0;
+}
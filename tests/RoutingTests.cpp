@@ -0,0 +1,123 @@
+#include "TestUtilities.h"
+
+//==============================================================================
+/*  Routage des bandes sur des dispositions multicanales : gauche, droite, milieu et côté ne
+    s'appliquent qu'aux vraies paires gauche / droite. Le centre et le LFE d'un 5.1, ou le
+    centre d'un LCR (dernier canal d'une disposition impaire), doivent sortir exactement comme
+    avec une bande stéréo, et un canal silencieux le rester ; les vraies paires (avant et
+    surround) gardent le routage (un signal purement latéral traverse une bande "Mid" sans
+    changer).
+*/
+class RoutingTests : public juce::UnitTest
+{
+public:
+    RoutingTests() : juce::UnitTest("Band routing on multichannel layouts", "SimpleDualParametricEq") {}
+
+    void runTest() override
+    {
+        for (auto routing : { ChannelRouting::left, ChannelRouting::right, ChannelRouting::mid, ChannelRouting::side })
+        {
+            auto routingName = EqParameters::getRoutingChoices()[(int) routing];
+
+            beginTest("5.1, " + routingName);
+            checkLayout(juce::AudioChannelSet::create5point1(), routing);
+
+            beginTest("LCR, " + routingName);
+            checkLayout(juce::AudioChannelSet::createLCR(), routing);
+        }
+    }
+
+private:
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 256;
+    static constexpr int numBlocks = 20;
+
+    static bool isStereoPair(const juce::AudioChannelSet &layout, int channel)
+    {
+        return EqEngine<float, EqParameters::numBands>::isStereoPair(layout, channel / 2);
+    }
+
+    // Sinusoïde de 1 kHz, d'amplitude différente par canal ; les deux canaux d'une vraie paire en opposition
+    // (côté pur), LFE silencieux
+    static double getInput(const juce::AudioChannelSet &layout, int channel, int sample)
+    {
+        auto sine = std::sin(juce::MathConstants<double>::twoPi * 1000.0 * (double) sample / sampleRate);
+
+        if (isStereoPair(layout, channel))
+            return (channel % 2 == 0 ? 0.1 : -0.1) * (1.0 + channel / 2) * sine;
+
+        if (layout.getTypeOfChannel(channel) == juce::AudioChannelSet::LFE)
+            return 0.0;
+
+        return (0.1 + 0.05 * channel) * sine;
+    }
+
+    std::vector<std::vector<float>> render(const juce::AudioChannelSet &layout, ChannelRouting routing)
+    {
+        AudioPluginAudioProcessor processor;
+        TestUtilities::setBandParameter(processor, 0, EqParameters::BandField::freq, 1000.0f);
+        TestUtilities::setBandParameter(processor, 0, EqParameters::BandField::gain, 12.0f);
+        TestUtilities::setBandParameter(processor, 0, EqParameters::BandField::routing, (float) routing);
+
+        std::vector<std::vector<float>> output((size_t) layout.size());
+
+        if (! TestUtilities::prepare(processor, sampleRate, blockSize, false, layout.size()))
+        {
+            expect(false, "layout refused");
+            return output;
+        }
+
+        juce::AudioBuffer<float> buffer(processor.getTotalNumInputChannels(), blockSize);
+        juce::MidiBuffer midi;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            for (int channel = 0; channel < layout.size(); ++channel)
+                for (int i = 0; i < blockSize; ++i)
+                    buffer.setSample(channel, i, (float) getInput(layout, channel, block * blockSize + i));
+
+            processor.processBlock(buffer, midi);
+
+            for (int channel = 0; channel < layout.size(); ++channel)
+                for (int i = 0; i < blockSize; ++i)
+                    output[(size_t) channel].push_back(buffer.getSample(channel, i));
+        }
+
+        processor.releaseResources();
+        return output;
+    }
+
+    void checkLayout(const juce::AudioChannelSet &layout, ChannelRouting routing)
+    {
+        auto routed = render(layout, routing);
+        auto stereo = render(layout, ChannelRouting::stereo);
+
+        for (int channel = 0; channel < layout.size(); ++channel)
+        {
+            auto channelName = juce::AudioChannelSet::getAbbreviatedChannelTypeName(layout.getTypeOfChannel(channel));
+            auto isPair = isStereoPair(layout, channel);
+            auto isLeft = channel % 2 == 0;
+
+            // Dans une paire, le côté pur n'est touché que par "Side" et par le canal traité de "Left" / "Right" ;
+            // hors paire, la sortie est celle d'une bande stéréo
+            auto untouched = ! isPair || routing == ChannelRouting::mid
+                          || (routing == ChannelRouting::left && ! isLeft) || (routing == ChannelRouting::right && isLeft);
+
+            if (! untouched)
+                continue;
+
+            auto &output = routed[(size_t) channel];
+            double largestDifference = 0.0;
+
+            for (size_t i = 0; i < output.size(); ++i)
+            {
+                auto expected = isPair ? getInput(layout, channel, (int) i) : (double) stereo[(size_t) channel][i];
+                largestDifference = juce::jmax(largestDifference, std::abs((double) output[i] - expected));
+            }
+
+            expectLessOrEqual(largestDifference, 1.0e-5, channelName + " changed by the routing");
+        }
+    }
+};
+
+static RoutingTests routingTests;
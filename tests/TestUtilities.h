@@ -0,0 +1,51 @@
+#pragma once
+
+#include "PluginProcessor.h"
+
+//==============================================================================
+// Outils communs des tests : réglage des paramètres et préparation du processeur comme par un hôte
+namespace TestUtilities
+{
+    // Valeur dans l'unité du paramètre (Hz, dB, index de choix...)
+    inline void setParameter(AudioPluginAudioProcessor &processor, const juce::String &id, float value)
+    {
+        auto *parameter = processor.getValueTreeState().getParameter(id);
+        jassert(parameter != nullptr);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    inline void setBandParameter(AudioPluginAudioProcessor &processor, int band, EqParameters::BandField field, float value)
+    {
+        setParameter(processor, EqParameters::getParameterID(band, field), value);
+    }
+
+    // Disposition (entrée = sortie, sidechain stéréo en option), précision, puis prepareToPlay
+    inline bool prepare(AudioPluginAudioProcessor &processor, double sampleRate, int blockSize, bool doublePrecision,
+                        int numChannels = 2, bool sidechain = false)
+    {
+        auto channelSet = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(channelSet);
+        layout.inputBuses.add(sidechain ? juce::AudioChannelSet::stereo() : juce::AudioChannelSet::disabled());
+        layout.outputBuses.add(channelSet);
+
+        if (! processor.setBusesLayout(layout))
+            return false;
+
+        processor.setProcessingPrecision(doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                         : juce::AudioProcessor::singlePrecision);
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+        return true;
+    }
+
+    // Bruit blanc à -12 dBFS sur tous les canaux
+    template <typename SampleType>
+    void fillWithNoise(juce::AudioBuffer<SampleType> &buffer, juce::Random &random)
+    {
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample(channel, i, (SampleType) (0.5f * (random.nextFloat() - 0.5f)));
+    }
+}
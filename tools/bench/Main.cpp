@@ -0,0 +1,1336 @@
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_osc/juce_osc.h>
+#include <thread>
+#include "AllocationCounter.h"
+#include "PluginProcessor.h"
+
+//==============================================================================
+/*  Banc de mesure du DSP : fait tourner AudioPluginAudioProcessor::processBlock sur une
+    matrice de tailles de bloc, fréquences d'échantillonnage, nombres de canaux, précisions
+    et motifs d'automation, et écrit les résultats en JSON pour comparer les versions
+    entre elles (x86 et ARM).
+
+    Pour chaque cas : ns par échantillon (par canal), p50 / p99 / max du temps par bloc,
+    et nombre d'allocations par bloc (operator new, et malloc sous Linux ; comptées seulement
+    pendant processBlock).
+    Quelques mesures de composants suivent : surcoût par bloc des paramètres (recherche
+    par identifiant contre compteur de génération), cascade fusionnée contre une passe
+    par bande (blocs de 512 à 16384 échantillons), cascade SIMD contre un IIR::Filter
+    scalaire par canal, écart des cloches bilinéaire et "matched" avec la
+    cloche analogique, coût du lissage et des deux structures de cellule, charge et
+    latence du mode phase linéaire selon la longueur du FIR, puis du suréchantillonnage
+    selon le facteur et les filtres, coût du routage milieu / côté, des dispositions
+    jusqu'à 16 canaux et par bande dynamique, charge sur du silence, surcoût de la mesure
+    de charge et de l'analyseur de spectre, un test de charge de la télécommande OSC, et
+    la taille et le temps de sauvegarde et de relecture de l'état, binaire contre XML.
+
+    Les chiffres n'ont de sens qu'en Release : le JSON indique le type de build.
+*/
+
+//==============================================================================
+namespace
+{
+    enum class Automation
+    {
+        none,       // paramètres fixes
+        stepped,    // sauts de fréquence et de gain toutes les 50 ms
+        sweep       // balayage continu de la fréquence et du gain, à chaque bloc
+    };
+
+    const char *getAutomationName(Automation automation)
+    {
+        switch (automation)
+        {
+            case Automation::stepped: return "stepped";
+            case Automation::sweep:   return "sweep";
+            case Automation::none:    break;
+        }
+
+        return "static";
+    }
+
+    // getHighResolutionTicks() n'a qu'une résolution d'une microseconde sous Linux : trop peu pour les petits blocs
+    using Clock = std::chrono::steady_clock;
+
+    struct BenchCase
+    {
+        int blockSize = 512;
+        double sampleRate = 48000.0;
+        int numChannels = 2;
+        Automation automation = Automation::none;
+        bool doublePrecision = false;
+        int smoothing = 2;  // index du choix SMOOTHING
+        int topology = 0;   // index du choix EQn_TOPOLOGY
+        bool linearPhase = false;
+        int firLength = 2;  // index du choix FIR_LENGTH
+        bool analyser = false;
+        int oversampling = 0;           // index du choix OVERSAMPLING
+        int oversamplingFilter = 0;     // index du choix OVERSAMPLING_FILTER
+        int dynamicBands = 0;           // les premières bandes passent en mode dynamique
+        bool sidechain = false;         // bus de sidechain stéréo actif, utilisé par les bandes dynamiques
+        int routing = 0;                // index du choix EQn_ROUTING, pour les deux premières bandes
+        bool silentInput = false;       // silence numérique à la place du bruit blanc
+    };
+
+    struct BenchSettings
+    {
+        double secondsPerCase = 1.0;
+        bool quick = false;
+        juce::File output;
+    };
+
+    void setParameter(juce::AudioProcessorValueTreeState &parameters, const juce::String &id, float value)
+    {
+        if (auto *parameter = parameters.getParameter(id))
+            parameter->setValueNotifyingHost(parameters.getParameterRange(id).convertTo0to1(value));
+    }
+
+    // Réglage de départ : deux cloches actives, au milieu du spectre
+    void setInitialParameters(juce::AudioProcessorValueTreeState &parameters, const BenchCase &benchCase)
+    {
+        setParameter(parameters, "EQ1_FREQ", 200.0f);
+        setParameter(parameters, "EQ1_GAIN", 6.0f);
+        setParameter(parameters, "EQ1_Q", 1.0f);
+        setParameter(parameters, "EQ2_FREQ", 4000.0f);
+        setParameter(parameters, "EQ2_GAIN", -6.0f);
+        setParameter(parameters, "EQ2_Q", 2.0f);
+        setParameter(parameters, "EQ1_TOPOLOGY", (float) benchCase.topology);
+        setParameter(parameters, "EQ2_TOPOLOGY", (float) benchCase.topology);
+        setParameter(parameters, "EQ1_ROUTING", (float) benchCase.routing);
+        setParameter(parameters, "EQ2_ROUTING", (float) benchCase.routing);
+        setParameter(parameters, "SMOOTHING", (float) benchCase.smoothing);
+        setParameter(parameters, "PHASE_MODE", benchCase.linearPhase ? 1.0f : 0.0f);
+        setParameter(parameters, "FIR_LENGTH", (float) benchCase.firLength);
+        setParameter(parameters, "OVERSAMPLING", (float) benchCase.oversampling);
+        setParameter(parameters, "OVERSAMPLING_FILTER", (float) benchCase.oversamplingFilter);
+
+        // Seuil assez bas pour que le bruit de test le dépasse dans chaque bande : le gain bouge en permanence
+        for (int band = 0; band < juce::jmin(benchCase.dynamicBands, EqParameters::numBands); ++band)
+        {
+            if (band >= 2)
+                setParameter(parameters, EqParameters::getParameterID(band, EqParameters::BandField::gain), -6.0f);
+
+            setParameter(parameters, EqParameters::getParameterID(band, EqParameters::BandField::dynamic), 1.0f);
+            setParameter(parameters, EqParameters::getParameterID(band, EqParameters::BandField::threshold), -40.0f);
+            setParameter(parameters, EqParameters::getParameterID(band, EqParameters::BandField::sidechain),
+                         benchCase.sidechain ? 1.0f : 0.0f);
+        }
+    }
+
+    // Automation appliquée avant le bloc commençant à l'échantillon position, comme le ferait l'hôte
+    void automate(juce::AudioProcessorValueTreeState &parameters, const BenchCase &benchCase, juce::int64 position)
+    {
+        auto seconds = (double) position / benchCase.sampleRate;
+
+        if (benchCase.automation == Automation::stepped)
+        {
+            auto step = (juce::int64) (seconds / 0.05);
+            auto previousStep = (juce::int64) ((double) (position - benchCase.blockSize) / benchCase.sampleRate / 0.05);
+
+            if (position == 0 || step != previousStep)
+            {
+                setParameter(parameters, "EQ1_FREQ", step % 2 == 0 ? 200.0f : 2000.0f);
+                setParameter(parameters, "EQ2_GAIN", step % 2 == 0 ? -6.0f : 9.0f);
+            }
+        }
+        else if (benchCase.automation == Automation::sweep)
+        {
+            // Une décade et demie aller-retour toutes les deux secondes
+            auto phase = std::fmod(seconds, 2.0) / 2.0;
+            auto sweep = 1.0 - std::abs(2.0 * phase - 1.0);
+            setParameter(parameters, "EQ1_FREQ", (float) (100.0 * std::pow(10.0, 1.5 * sweep)));
+            setParameter(parameters, "EQ2_GAIN", (float) (12.0 * std::sin(juce::MathConstants<double>::twoPi * seconds)));
+        }
+    }
+
+    juce::var summarise(std::vector<double> &blockNanoseconds, juce::int64 numSamples, int numChannels, juce::int64 allocations)
+    {
+        auto total = std::accumulate(blockNanoseconds.begin(), blockNanoseconds.end(), 0.0);
+        std::sort(blockNanoseconds.begin(), blockNanoseconds.end());
+
+        auto percentile = [&](double p)
+        {
+            auto index = (size_t) juce::jlimit(0.0, (double) blockNanoseconds.size() - 1.0, std::ceil(p * (double) blockNanoseconds.size()) - 1.0);
+            return blockNanoseconds[index];
+        };
+
+        auto *result = new juce::DynamicObject();
+        result->setProperty("nsPerSample", total / (double) (numSamples * numChannels));
+        result->setProperty("blockP50Ns", percentile(0.5));
+        result->setProperty("blockP99Ns", percentile(0.99));
+        result->setProperty("blockMaxNs", blockNanoseconds.back());
+        result->setProperty("allocationsPerBlock", (double) allocations / (double) blockNanoseconds.size());
+        result->setProperty("blocks", (int) blockNanoseconds.size());
+        return result;
+    }
+
+    template <typename SampleType>
+    juce::var runCase(const BenchCase &benchCase, double seconds)
+    {
+        AudioPluginAudioProcessor processor;
+        auto &parameters = processor.getValueTreeState();
+        auto channelSet = juce::AudioChannelSet::canonicalChannelSet(benchCase.numChannels);
+
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(channelSet);
+        layout.inputBuses.add(benchCase.sidechain ? juce::AudioChannelSet::stereo() : juce::AudioChannelSet::disabled());
+        layout.outputBuses.add(channelSet);
+
+        if (! processor.setBusesLayout(layout))
+            return {};
+
+        // Canaux du sidechain après ceux de l'entrée principale, remplis du même bruit
+        auto numBufferChannels = processor.getTotalNumInputChannels();
+
+        setInitialParameters(parameters, benchCase);
+        processor.setProcessingPrecision(benchCase.doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                                   : juce::AudioProcessor::singlePrecision);
+        processor.setRateAndBufferSizeDetails(benchCase.sampleRate, benchCase.blockSize);
+        processor.prepareToPlay(benchCase.sampleRate, benchCase.blockSize);
+        processor.getAnalyser().setActive(benchCase.analyser);
+
+        // Bruit blanc à -12 dBFS, recopié avant chaque bloc pour que le signal ne décroisse pas vers les dénormaux
+        juce::AudioBuffer<SampleType> source(numBufferChannels, benchCase.blockSize), buffer(numBufferChannels, benchCase.blockSize);
+        juce::Random random(1);
+
+        for (int channel = 0; channel < numBufferChannels; ++channel)
+            for (int i = 0; i < benchCase.blockSize; ++i)
+                source.setSample(channel, i, benchCase.silentInput ? SampleType() : (SampleType) (0.5f * (random.nextFloat() - 0.5f)));
+
+        juce::MidiBuffer midi;
+        auto warmupBlocks = juce::jmax(8, (int) (0.1 * benchCase.sampleRate) / benchCase.blockSize);
+        auto numBlocks = juce::jmax(16, (int) (seconds * benchCase.sampleRate) / benchCase.blockSize);
+
+        std::vector<double> blockNanoseconds;
+        blockNanoseconds.reserve((size_t) numBlocks);
+        juce::int64 allocations = 0;
+        juce::int64 position = 0;
+
+        for (int block = 0; block < warmupBlocks + numBlocks; ++block)
+        {
+            automate(parameters, benchCase, position);
+            buffer.makeCopyOf(source, true);
+
+            AllocationCounter::start();
+            auto start = Clock::now();
+
+            processor.processBlock(buffer, midi);
+
+            auto end = Clock::now();
+            auto blockAllocations = AllocationCounter::stop();
+
+            if (block >= warmupBlocks)
+            {
+                blockNanoseconds.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+                allocations += blockAllocations;
+            }
+
+            position += benchCase.blockSize;
+        }
+
+        processor.getAnalyser().setActive(false);
+        processor.releaseResources();
+
+        auto result = summarise(blockNanoseconds, (juce::int64) numBlocks * benchCase.blockSize, benchCase.numChannels, allocations);
+        auto *object = result.getDynamicObject();
+        object->setProperty("blockSize", benchCase.blockSize);
+        object->setProperty("sampleRate", benchCase.sampleRate);
+        object->setProperty("channels", benchCase.numChannels);
+        object->setProperty("automation", getAutomationName(benchCase.automation));
+        object->setProperty("precision", benchCase.doublePrecision ? "double" : "float");
+        object->setProperty("smoothing", EqParameters::getSmoothingChoices()[benchCase.smoothing]);
+        object->setProperty("topology", EqParameters::getTopologyChoices()[benchCase.topology]);
+        object->setProperty("phaseMode", EqParameters::getPhaseModeChoices()[benchCase.linearPhase ? 1 : 0]);
+        object->setProperty("latencySamples", processor.getLatencySamples());
+        object->setProperty("analyser", benchCase.analyser);
+        object->setProperty("oversampling", EqParameters::getOversamplingChoices()[benchCase.oversampling]);
+        object->setProperty("oversamplingFilter", EqParameters::getOversamplingFilterChoices()[benchCase.oversamplingFilter]);
+        object->setProperty("dynamicBands", benchCase.dynamicBands);
+        object->setProperty("sidechain", benchCase.sidechain);
+        object->setProperty("routing", EqParameters::getRoutingChoices()[benchCase.routing]);
+        return result;
+    }
+
+    juce::var runCase(const BenchCase &benchCase, double seconds)
+    {
+        auto result = benchCase.doublePrecision ? runCase<double>(benchCase, seconds) : runCase<float>(benchCase, seconds);
+
+        if (auto *object = result.getDynamicObject())
+            std::cout << juce::String(object->getProperty("precision").toString()).paddedRight(' ', 7)
+                      << juce::String(benchCase.sampleRate / 1000.0, 1).paddedLeft(' ', 6) << " kHz"
+                      << juce::String(benchCase.numChannels).paddedLeft(' ', 3) << " ch"
+                      << juce::String(benchCase.blockSize).paddedLeft(' ', 6) << " smp  "
+                      << juce::String(getAutomationName(benchCase.automation)).paddedRight(' ', 8)
+                      << juce::String(object->getProperty("topology").toString()).paddedRight(' ', 8)
+                      << juce::String(object->getProperty("smoothing").toString()).paddedRight(' ', 11)
+                      << juce::String((double) object->getProperty("nsPerSample"), 2).paddedLeft(' ', 8) << " ns/smp  p99 "
+                      << juce::String((double) object->getProperty("blockP99Ns") / 1000.0, 1).paddedLeft(' ', 8) << " us  max "
+                      << juce::String((double) object->getProperty("blockMaxNs") / 1000.0, 1).paddedLeft(' ', 8) << " us  allocs "
+                      << juce::String((double) object->getProperty("allocationsPerBlock"), 2) << std::endl;
+
+        return result;
+    }
+
+    // Charge de processBlock tous canaux confondus, en % de la durée du signal
+    double getRealtimePercent(const juce::var &result, const BenchCase &benchCase)
+    {
+        return (double) result.getProperty("nsPerSample", 0.0) * benchCase.numChannels * benchCase.sampleRate * 1.0e-9 * 100.0;
+    }
+
+    // Cas d'une mesure de composant, sans affichage, avec sa charge en "realtimePercent" ; vide si la disposition est refusée
+    juce::var runComponentCase(const BenchCase &benchCase, double seconds)
+    {
+        auto result = benchCase.doublePrecision ? runCase<double>(benchCase, seconds) : runCase<float>(benchCase, seconds);
+
+        if (auto *object = result.getDynamicObject())
+            object->setProperty("realtimePercent", getRealtimePercent(result, benchCase));
+
+        return result;
+    }
+
+    // Bruit blanc à -12 dBFS
+    void fillWithNoise(juce::AudioBuffer<float> &buffer)
+    {
+        juce::Random random(1);
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                buffer.setSample(channel, i, 0.5f * (random.nextFloat() - 0.5f));
+    }
+
+    // ns par échantillon et par canal de numBlocks appels de processOneBlock
+    template <typename Function>
+    double measureNsPerSample(int numBlocks, int blockSize, int numChannels, Function &&processOneBlock)
+    {
+        auto start = Clock::now();
+
+        for (int i = 0; i < numBlocks; ++i)
+            processOneBlock();
+
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / ((double) numBlocks * blockSize * numChannels);
+    }
+
+    //==============================================================================
+    /*  Surcoût par bloc de la mise à jour des bandes à paramètres fixes, pour des blocs de 16 à
+        1024 échantillons à 48 kHz, toutes bandes comprises :
+        - ancien chemin : recherche de chaque paramètre de la bande par son identifiant, puis
+          calcul des coefficients, à chaque bloc ;
+        - nouveau chemin : compteur de génération de la bande comparé à celui du bloc
+          précédent, et rien d'autre quand il n'a pas bougé ;
+        - nouveau chemin quand une bande a changé : lecture des atomiques en cache et calcul.
+        En % de la durée du bloc, le surcoût fixe pèse d'autant plus que le bloc est court.
+    */
+    juce::var benchParameterAccess(double seconds)
+    {
+        using Field = EqParameters::BandField;
+
+        constexpr double sampleRate = 48000.0;
+        const Field fields[] { Field::freq, Field::gain, Field::q, Field::on, Field::topology, Field::type, Field::routing };
+        constexpr auto numFields = std::size(fields);
+
+        AudioPluginAudioProcessor processor;
+        auto &parameters = processor.getValueTreeState();
+        auto &eqParameters = processor.getEqParameters();
+        juce::StringArray ids;
+
+        for (int band = 0; band < EqParameters::numBands; ++band)
+            for (auto field : fields)
+                ids.add(EqParameters::getParameterID(band, field));
+
+        std::array<BiquadCoefficients<float>, EqFilterDesign::maxSectionsPerFilter> sections;
+        std::array<juce::uint32, (size_t) EqParameters::numBands> appliedGenerations;
+        auto sink = 0.0f;
+
+        auto design = [&](float freq, float gain, float q, float type)
+        {
+            auto filterType = (FilterType) juce::jlimit(0, (int) EqFilterDesign::lastFilterType, juce::roundToInt(type));
+            EqFilterDesign::design<float>(filterType, sampleRate, freq, q, gain, sections.data());
+            sink += sections[0].b0;
+        };
+
+        auto lookupAndDesign = [&]
+        {
+            for (int band = 0; band < EqParameters::numBands; ++band)
+            {
+                std::array<float, numFields> values;
+
+                for (size_t f = 0; f < numFields; ++f)
+                    values[f] = parameters.getRawParameterValue(ids[band * (int) numFields + (int) f])->load();
+
+                sink += values[3] + values[4] + values[6];
+                design(values[0], values[1], values[2], values[5]);
+            }
+        };
+
+        auto cachedAndDesign = [&]
+        {
+            for (int band = 0; band < EqParameters::numBands; ++band)
+            {
+                auto &bandParameters = eqParameters.getBand(band);
+                sink += bandParameters.on->load() + bandParameters.topology->load() + bandParameters.routing->load();
+                design(bandParameters.freq->load(), bandParameters.gain->load(), bandParameters.q->load(), bandParameters.type->load());
+            }
+        };
+
+        auto generationSkip = [&]
+        {
+            for (int band = 0; band < EqParameters::numBands; ++band)
+            {
+                auto generation = eqParameters.getBand(band).generation.load(std::memory_order_acquire);
+
+                if (generation == appliedGenerations[(size_t) band])
+                    continue;
+
+                appliedGenerations[(size_t) band] = generation;
+                cachedAndDesign();
+            }
+        };
+
+        for (int band = 0; band < EqParameters::numBands; ++band)
+            appliedGenerations[(size_t) band] = eqParameters.getBand(band).generation.load();
+
+        juce::Array<juce::var> results;
+
+        std::cout << std::endl << "Parameters block   ns/block: lookup + design   skip   cached + design"
+                  << "   % of block: lookup     skip" << std::endl;
+
+        for (auto blockSize : { 16, 32, 64, 128, 256, 512, 1024 })
+        {
+            // Au moins 10 000 blocs : le coût d'un bloc est de l'ordre de la centaine de ns
+            auto numBlocks = juce::jmax(10000, (int) (seconds * sampleRate) / blockSize);
+            auto blockPeriodNs = blockSize / sampleRate * 1.0e9;
+
+            // measureNsPerSample() avec un seul échantillon par bloc : ns par bloc
+            auto lookupNs = measureNsPerSample(numBlocks, 1, 1, lookupAndDesign);
+            auto skipNs = measureNsPerSample(numBlocks, 1, 1, generationSkip);
+            auto cachedNs = measureNsPerSample(numBlocks, 1, 1, cachedAndDesign);
+
+            auto *blockResult = new juce::DynamicObject();
+            blockResult->setProperty("blockSize", blockSize);
+            blockResult->setProperty("bands", EqParameters::numBands);
+            blockResult->setProperty("lookupAndDesignNsPerBlock", lookupNs);
+            blockResult->setProperty("generationSkipNsPerBlock", skipNs);
+            blockResult->setProperty("cachedAndDesignNsPerBlock", cachedNs);
+            blockResult->setProperty("lookupAndDesignRealtimePercent", lookupNs / blockPeriodNs * 100.0);
+            blockResult->setProperty("generationSkipRealtimePercent", skipNs / blockPeriodNs * 100.0);
+            results.add(blockResult);
+
+            std::cout << juce::String(blockSize).paddedLeft(' ', 16)
+                      << juce::String(lookupNs, 1).paddedLeft(' ', 28)
+                      << juce::String(skipNs, 1).paddedLeft(' ', 7)
+                      << juce::String(cachedNs, 1).paddedLeft(' ', 18)
+                      << juce::String(lookupNs / blockPeriodNs * 100.0, 3).paddedLeft(' ', 23)
+                      << juce::String(skipNs / blockPeriodNs * 100.0, 5).paddedLeft(' ', 9) << std::endl;
+        }
+
+        auto *result = new juce::DynamicObject();
+        result->setProperty("blockSizes", results);
+        result->setProperty("checksum", sink);
+        return result;
+    }
+
+    // Les deux cloches du réglage de départ dans la cascade SIMD, hors du processeur
+    struct BellCascade
+    {
+        using Lanes = LaneInterleaver<float>::Lanes;
+
+        static constexpr auto sectionsPerBand = (size_t) EqBand<float>::maxSections;
+
+        explicit BellCascade(const juce::dsp::ProcessSpec &spec)
+            : states(LaneInterleaver<float>::getNumGroups(spec.numChannels) * bands.size() * sectionsPerBand)
+        {
+            interleaver.prepare(spec);
+            cascade.prepare(spec.numChannels, std::vector<bool>(spec.numChannels / 2, true));
+
+            for (size_t i = 0; i < bands.size(); ++i)
+            {
+                bands[i].prepare(spec, states.data() + i * sectionsPerBand, bands.size() * sectionsPerBand);
+                bands[i].setEnabled(true, true);
+            }
+
+            bands[0].setParameters(200.0f, 6.0f, 1.0f, true);
+            bands[1].setParameters(4000.0f, -6.0f, 2.0f, true);
+        }
+
+        LaneInterleaver<float> interleaver;
+        EqCascade<float> cascade;
+        std::array<EqBand<float>, 2> bands;
+        std::array<EqBand<float> *, 2> both { &bands[0], &bands[1] };
+        std::vector<SectionState<Lanes>> states;
+    };
+
+    /*  Les deux bandes dans une seule passe fusionnée, contre une passe complète par bande, en
+        stéréo à 48 kHz : d'un bloc de taille courante aux grands tampons (rendu hors ligne), où
+        la seconde passe relit le bloc entier hors du cache.
+    */
+    juce::var benchCascade(int blockSize, double seconds)
+    {
+        constexpr int numChannels = 2;
+        const juce::dsp::ProcessSpec spec { 48000.0, (juce::uint32) blockSize, (juce::uint32) numChannels };
+
+        BellCascade bells(spec);
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        fillWithNoise(buffer);
+
+        juce::dsp::AudioBlock<float> block(buffer);
+        auto lanes = bells.interleaver.interleave(juce::dsp::AudioBlock<const float>(block));
+        auto numBlocks = juce::jmax(16, (int) (seconds * spec.sampleRate) / blockSize);
+
+        juce::ScopedNoDenormals noDenormals;
+
+        auto fused = measureNsPerSample(numBlocks, blockSize, numChannels, [&]
+        {
+            bells.cascade.process(lanes, bells.both.data(), bells.both.size(), 0);
+        });
+
+        auto separate = measureNsPerSample(numBlocks, blockSize, numChannels, [&]
+        {
+            bells.cascade.process(lanes, bells.both.data(), 1, 0);
+            bells.cascade.process(lanes, bells.both.data() + 1, 1, 0);
+        });
+
+        auto *result = new juce::DynamicObject();
+        result->setProperty("blockSize", blockSize);
+        result->setProperty("lanes", (int) BellCascade::Lanes::size());
+        result->setProperty("fusedNsPerSample", fused);
+        result->setProperty("passPerBandNsPerSample", separate);
+        result->setProperty("speedup", separate / fused);
+
+        std::cout << juce::String(blockSize).paddedLeft(' ', 13)
+                  << juce::String(fused, 2).paddedLeft(' ', 15)
+                  << juce::String(separate, 2).paddedLeft(' ', 18)
+                  << juce::String(separate / fused, 2).paddedLeft(' ', 10) << std::endl;
+
+        return result;
+    }
+
+    juce::var benchCascade(double seconds)
+    {
+        juce::Array<juce::var> results;
+
+        std::cout << std::endl << "Cascade block   fused ns/smp   per band ns/smp   speedup" << std::endl;
+
+        for (auto blockSize : { 512, 4096, 16384 })
+            results.add(benchCascade(blockSize, seconds));
+
+        return results;
+    }
+
+    /*  Référence scalaire : les mêmes deux cloches (cellules RBJ, comme EqFilterDesign) dans un
+        juce::dsp::IIR::Filter par canal (ProcessorDuplicator), contre le chemin du moteur
+        (entrelacement, cascade SIMD, désentrelacement), en stéréo à 48 kHz. Le rapport des
+        deux temps est le gain de la vectorisation par canaux, copies comprises.
+    */
+    juce::var benchScalarBaseline(double seconds)
+    {
+        using ScalarBell = juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>>;
+
+        constexpr int numChannels = 2;
+        constexpr double sampleRate = 48000.0;
+        juce::Array<juce::var> results;
+
+        std::cout << std::endl << "Scalar IIR block   scalar ns/smp   SIMD ns/smp   speedup" << std::endl;
+
+        for (auto blockSize : { 32, 512 })
+        {
+            const juce::dsp::ProcessSpec spec { sampleRate, (juce::uint32) blockSize, (juce::uint32) numChannels };
+
+            std::array<ScalarBell, 2> scalarBells;
+            *scalarBells[0].state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, 200.0f, 1.0f,
+                                                                                        juce::Decibels::decibelsToGain(6.0f));
+            *scalarBells[1].state = *juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, 4000.0f, 2.0f,
+                                                                                        juce::Decibels::decibelsToGain(-6.0f));
+
+            for (auto &bell : scalarBells)
+                bell.prepare(spec);
+
+            BellCascade bells(spec);
+            juce::AudioBuffer<float> buffer(numChannels, blockSize);
+            fillWithNoise(buffer);
+
+            juce::dsp::AudioBlock<float> block(buffer);
+            juce::dsp::ProcessContextReplacing<float> context(block);
+            auto numBlocks = juce::jmax(16, (int) (seconds * sampleRate) / blockSize);
+
+            juce::ScopedNoDenormals noDenormals;
+
+            auto scalar = measureNsPerSample(numBlocks, blockSize, numChannels, [&]
+            {
+                scalarBells[0].process(context);
+                scalarBells[1].process(context);
+            });
+
+            auto simd = measureNsPerSample(numBlocks, blockSize, numChannels, [&]
+            {
+                auto lanes = bells.interleaver.interleave(juce::dsp::AudioBlock<const float>(block));
+                bells.cascade.process(lanes, bells.both.data(), bells.both.size(), 0);
+                bells.interleaver.deinterleave(block);
+            });
+
+            auto *result = new juce::DynamicObject();
+            result->setProperty("blockSize", blockSize);
+            result->setProperty("channels", numChannels);
+            result->setProperty("lanes", (int) BellCascade::Lanes::size());
+            result->setProperty("scalarNsPerSample", scalar);
+            result->setProperty("simdNsPerSample", simd);
+            result->setProperty("speedup", scalar / simd);
+            results.add(result);
+
+            std::cout << juce::String(blockSize).paddedLeft(' ', 16)
+                      << juce::String(scalar, 2).paddedLeft(' ', 16)
+                      << juce::String(simd, 2).paddedLeft(' ', 14)
+                      << juce::String(scalar / simd, 2).paddedLeft(' ', 10) << std::endl;
+        }
+
+        return results;
+    }
+
+    /*  Coût d'un calcul de coefficients de cloche, bilinéaire et "matched", qui peut avoir lieu à
+        chaque sous-bloc pendant une rampe (l'écart avec la cloche analogique est vérifié par les tests).
+    */
+    juce::var benchBellDesign()
+    {
+        auto *result = new juce::DynamicObject();
+        std::cout << std::endl;
+
+        // Coût d'un calcul de cellule en float, fréquence différente à chaque appel
+        constexpr int iterations = 200000;
+        std::array<BiquadCoefficients<float>, EqFilterDesign::maxSectionsPerFilter> sections;
+        auto sink = 0.0f;
+
+        for (auto type : { FilterType::bell, FilterType::bellMatched })
+        {
+            auto start = Clock::now();
+
+            for (int i = 0; i < iterations; ++i)
+            {
+                EqFilterDesign::design<float>(type, 48000.0, 1000.0f + (float) (i % 1000), 1.0f, 6.0f, sections.data());
+                sink += sections[0].b0;
+            }
+
+            auto nanoseconds = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations;
+            result->setProperty(type == FilterType::bell ? "bilinearDesignNs" : "matchedDesignNs", nanoseconds);
+            std::cout << "design cost " << (type == FilterType::bell ? "bilinear " : "matched  ") << juce::String(nanoseconds, 1) << " ns" << std::endl;
+        }
+
+        result->setProperty("checksum", sink);
+        return result;
+    }
+
+    /*  Phase linéaire : charge CPU et latence pour chaque longueur de FIR, en stéréo à 48 kHz,
+        pour une petite et une grande taille de bloc (la convolution partitionnée coûte plus
+        cher par échantillon avec des petits blocs).
+    */
+    juce::var benchLinearPhase(double seconds)
+    {
+        juce::Array<juce::var> results;
+
+        std::cout << std::endl << "Linear phase   FIR length   latency (smp / ms)   block   ns/smp   % of realtime" << std::endl;
+
+        for (auto blockSize : { 64, 512 })
+        {
+            for (int choice = 0; choice < EqParameters::getFirLengthChoices().size(); ++choice)
+            {
+                BenchCase benchCase;
+                benchCase.blockSize = blockSize;
+                benchCase.linearPhase = true;
+                benchCase.firLength = choice;
+
+                auto result = runComponentCase(benchCase, seconds);
+                auto *object = result.getDynamicObject();
+
+                if (object == nullptr)
+                    continue;
+
+                auto latency = (int) object->getProperty("latencySamples");
+                auto nsPerSample = (double) object->getProperty("nsPerSample");
+                auto realtimeLoad = (double) object->getProperty("realtimePercent");
+                object->setProperty("firLength", EqParameters::getFirLengthChoices()[choice].getIntValue());
+
+                std::cout << juce::String(EqParameters::getFirLengthChoices()[choice]).paddedLeft(' ', 25)
+                          << juce::String(latency).paddedLeft(' ', 10) << " / "
+                          << juce::String(latency / benchCase.sampleRate * 1000.0, 1).paddedLeft(' ', 6)
+                          << juce::String(blockSize).paddedLeft(' ', 8)
+                          << juce::String(nsPerSample, 2).paddedLeft(' ', 9)
+                          << juce::String(realtimeLoad, 2).paddedLeft(' ', 16) << std::endl;
+
+                results.add(result);
+            }
+        }
+
+        return results;
+    }
+
+    /*  Suréchantillonnage : charge et latence pour chaque facteur et chaque famille de filtres,
+        en stéréo à 48 kHz. Le coût de la cascade est multiplié par le facteur, celui des filtres
+        de suréchantillonnage ne dépend pas du nombre de bandes.
+    */
+    juce::var benchOversampling(double seconds)
+    {
+        juce::Array<juce::var> results;
+
+        std::cout << std::endl << "Oversampling   filter              latency   block   ns/smp   % of realtime" << std::endl;
+
+        for (auto blockSize : { 64, 512 })
+        {
+            for (int factor = 0; factor < EqParameters::getOversamplingChoices().size(); ++factor)
+            {
+                for (int filter = 0; filter < EqParameters::getOversamplingFilterChoices().size(); ++filter)
+                {
+                    // Sans suréchantillonnage, les filtres ne servent pas
+                    if (factor == 0 && filter > 0)
+                        continue;
+
+                    BenchCase benchCase;
+                    benchCase.blockSize = blockSize;
+                    benchCase.oversampling = factor;
+                    benchCase.oversamplingFilter = filter;
+
+                    auto result = runComponentCase(benchCase, seconds);
+                    auto *object = result.getDynamicObject();
+
+                    if (object == nullptr)
+                        continue;
+
+                    auto nsPerSample = (double) object->getProperty("nsPerSample");
+                    auto realtimeLoad = (double) object->getProperty("realtimePercent");
+
+                    std::cout << juce::String(EqParameters::getOversamplingChoices()[factor]).paddedLeft(' ', 12)
+                              << "   " << juce::String(factor == 0 ? "-" : EqParameters::getOversamplingFilterChoices()[filter]).paddedRight(' ', 18)
+                              << juce::String((int) object->getProperty("latencySamples")).paddedLeft(' ', 8)
+                              << juce::String(blockSize).paddedLeft(' ', 8)
+                              << juce::String(nsPerSample, 2).paddedLeft(' ', 9)
+                              << juce::String(realtimeLoad, 2).paddedLeft(' ', 16) << std::endl;
+
+                    results.add(result);
+                }
+            }
+        }
+
+        return results;
+    }
+
+    /*  Routage des bandes : les deux cloches en stéréo, sur un seul canal, ou sur le milieu ou
+        le côté, en stéréo à 48 kHz. Le codage et le décodage milieu / côté se font dans le
+        noyau de la cascade : l'écart avec la stéréo est le coût de l'échange de voies et
+        du mélange, sans passe supplémentaire sur le bloc.
+    */
+    juce::var benchRouting(double seconds)
+    {
+        juce::Array<juce::var> results;
+
+        std::cout << std::endl << "Routing   block   ns/smp   % of realtime" << std::endl;
+
+        for (auto blockSize : { 64, 512 })
+        {
+            for (int routing = 0; routing < EqParameters::getRoutingChoices().size(); ++routing)
+            {
+                BenchCase benchCase;
+                benchCase.blockSize = blockSize;
+                benchCase.routing = routing;
+
+                auto result = runComponentCase(benchCase, seconds);
+                auto *object = result.getDynamicObject();
+
+                if (object == nullptr)
+                    continue;
+
+                auto nsPerSample = (double) object->getProperty("nsPerSample");
+                auto realtimeLoad = (double) object->getProperty("realtimePercent");
+
+                std::cout << juce::String(EqParameters::getRoutingChoices()[routing]).paddedLeft(' ', 7)
+                          << juce::String(blockSize).paddedLeft(' ', 8)
+                          << juce::String(nsPerSample, 2).paddedLeft(' ', 9)
+                          << juce::String(realtimeLoad, 3).paddedLeft(' ', 16) << std::endl;
+
+                results.add(result);
+            }
+        }
+
+        return results;
+    }
+
+    /*  Dispositions multicanales : temps par bloc de 512 échantillons à 48 kHz, de mono à
+        16 canaux, comparé à celui d'un bloc stéréo. Les canaux sont traités par groupes
+        dans les voies SIMD : le coût suit le nombre de groupes (floatLanes ou doubleLanes
+        canaux chacun) plus que le nombre de canaux.
+    */
+    juce::var benchChannels(double seconds)
+    {
+        juce::Array<juce::var> results;
+
+        std::cout << std::endl << "Channels precision   ns/block   stereo passes   % of realtime" << std::endl;
+
+        for (auto doublePrecision : { false, true })
+        {
+            double stereoNanoseconds = 0.0;
+
+            for (auto numChannels : { 2, 1, 4, 6, 8, 16 })
+            {
+                BenchCase benchCase;
+                benchCase.numChannels = numChannels;
+                benchCase.doublePrecision = doublePrecision;
+
+                auto result = runComponentCase(benchCase, seconds);
+                auto *object = result.getDynamicObject();
+
+                if (object == nullptr)
+                    continue;
+
+                auto nsPerSample = (double) object->getProperty("nsPerSample");
+                auto blockNanoseconds = nsPerSample * numChannels * benchCase.blockSize;
+                auto realtimeLoad = (double) object->getProperty("realtimePercent");
+
+                if (numChannels == 2)
+                    stereoNanoseconds = blockNanoseconds;
+
+                auto stereoPasses = stereoNanoseconds > 0.0 ? blockNanoseconds / stereoNanoseconds : 0.0;
+                object->setProperty("blockNs", blockNanoseconds);
+                object->setProperty("stereoPasses", stereoPasses);
+
+                std::cout << juce::String(numChannels).paddedLeft(' ', 8)
+                          << juce::String(doublePrecision ? "double" : "float").paddedLeft(' ', 10)
+                          << juce::String(juce::roundToInt(blockNanoseconds)).paddedLeft(' ', 11)
+                          << juce::String(stereoPasses, 2).paddedLeft(' ', 16)
+                          << juce::String(realtimeLoad, 3).paddedLeft(' ', 16) << std::endl;
+
+                results.add(result);
+            }
+        }
+
+        return results;
+    }
+
+    /*  Silence : charge de processBlock sur du bruit puis sur du silence numérique, de 2 à 16
+        canaux à 48 kHz. Le préchauffage (0,1 s) dépasse la résonance des réglages par défaut :
+        pendant la mesure, le silence ne coûte plus que sa détection et la mise à zéro.
+    */
+    juce::var benchIdle(double seconds)
+    {
+        juce::Array<juce::var> results;
+
+        std::cout << std::endl << "Idle  channels   input   ns/block   % of realtime" << std::endl;
+
+        for (auto numChannels : { 2, 16 })
+        {
+            for (auto silentInput : { false, true })
+            {
+                BenchCase benchCase;
+                benchCase.numChannels = numChannels;
+                benchCase.silentInput = silentInput;
+
+                auto result = runComponentCase(benchCase, seconds);
+                auto *object = result.getDynamicObject();
+
+                if (object == nullptr)
+                    continue;
+
+                auto nsPerSample = (double) object->getProperty("nsPerSample");
+                auto realtimeLoad = (double) object->getProperty("realtimePercent");
+                object->setProperty("input", silentInput ? "silence" : "noise");
+
+                std::cout << juce::String(numChannels).paddedLeft(' ', 14)
+                          << juce::String(silentInput ? "silence" : "noise").paddedLeft(' ', 8)
+                          << juce::String(juce::roundToInt(nsPerSample * numChannels * benchCase.blockSize)).paddedLeft(' ', 11)
+                          << juce::String(realtimeLoad, 3).paddedLeft(' ', 16) << std::endl;
+
+                results.add(result);
+            }
+        }
+
+        return results;
+    }
+
+    /*  Surcoût de la mesure de charge par appel de processBlock : deux lectures de l'horloge,
+        plus la charge lissée et l'histogramme. La lecture seule de l'horloge est mesurée à
+        part : c'est le plancher, qui dépend de la machine (bien plus lent sous virtualisation).
+    */
+    juce::var benchLoadMonitor()
+    {
+        EqLoadMonitor monitor;
+        monitor.prepare(48000.0, 512);
+
+        constexpr int iterations = 1000000;
+        std::chrono::steady_clock::rep sink = 0;
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < iterations; ++i)
+            sink += std::chrono::steady_clock::now().time_since_epoch().count();
+
+        auto clockEnd = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < iterations; ++i)
+            EqLoadMonitor::ScopedTimer timer(monitor, 512);
+
+        auto end = std::chrono::steady_clock::now();
+
+        auto clockNs = (double) std::chrono::duration_cast<std::chrono::nanoseconds>(clockEnd - start).count() / iterations;
+        auto nsPerBlock = (double) std::chrono::duration_cast<std::chrono::nanoseconds>(end - clockEnd).count() / iterations;
+
+        std::cout << std::endl << "Load monitor: " << juce::String(nsPerBlock, 1) << " ns per block"
+                  << (EqLoadMonitor::isEnabled ? "" : " (disabled)") << ", clock read " << juce::String(clockNs, 1) << " ns" << std::endl;
+
+        auto *result = new juce::DynamicObject();
+        result->setProperty("enabled", EqLoadMonitor::isEnabled);
+        result->setProperty("nsPerBlock", nsPerBlock);
+        result->setProperty("clockNsPerRead", clockNs);
+        result->setProperty("checksum", (double) (sink & 1));
+        return result;
+    }
+
+    /*  Mode dynamique : charge selon le nombre de bandes dynamiques, en stéréo à 48 kHz, avec
+        le lissage par défaut (coefficients recalculés tous les 16 échantillons). Le coût par
+        bande dynamique est l'écart avec le même réglage statique, divisé par le nombre de
+        bandes dynamiques : détecteur (passe-bande et enveloppe, en mono), calcul des
+        coefficients à chaque sous-bloc et cascade en rampe.
+    */
+    juce::var benchDynamics(double seconds)
+    {
+        juce::Array<juce::var> results;
+
+        std::cout << std::endl << "Dynamic bands   sidechain   block   ns/smp   % of realtime   per band %" << std::endl;
+
+        for (auto blockSize : { 64, 512 })
+        {
+            double staticLoad = 0.0;
+
+            for (int dynamicBands = 0; dynamicBands <= EqParameters::numBands; ++dynamicBands)
+            {
+                for (auto sidechain : { false, true })
+                {
+                    // Le sidechain ne sert qu'aux bandes dynamiques
+                    if (sidechain && dynamicBands != EqParameters::numBands)
+                        continue;
+
+                    BenchCase benchCase;
+                    benchCase.blockSize = blockSize;
+                    benchCase.dynamicBands = dynamicBands;
+                    benchCase.sidechain = sidechain;
+
+                    auto result = runComponentCase(benchCase, seconds);
+                    auto *object = result.getDynamicObject();
+
+                    if (object == nullptr)
+                        continue;
+
+                    auto nsPerSample = (double) object->getProperty("nsPerSample");
+                    auto realtimeLoad = (double) object->getProperty("realtimePercent");
+
+                    if (dynamicBands == 0)
+                        staticLoad = realtimeLoad;
+
+                    auto perBand = dynamicBands > 0 ? (realtimeLoad - staticLoad) / dynamicBands : 0.0;
+                    object->setProperty("realtimePercentPerDynamicBand", perBand);
+
+                    std::cout << juce::String(dynamicBands).paddedLeft(' ', 13)
+                              << juce::String(sidechain ? "on" : "off").paddedLeft(' ', 12)
+                              << juce::String(blockSize).paddedLeft(' ', 8)
+                              << juce::String(nsPerSample, 2).paddedLeft(' ', 9)
+                              << juce::String(realtimeLoad, 3).paddedLeft(' ', 16)
+                              << juce::String(dynamicBands > 0 ? juce::String(perBand, 3) : juce::String("-")).paddedLeft(' ', 13)
+                              << std::endl;
+
+                    results.add(result);
+                }
+            }
+        }
+
+        return results;
+    }
+
+    /*  Analyseur de spectre : surcoût de l'envoi des échantillons au thread de fond, mesuré sur
+        processBlock à 48 kHz, blocs de 64 échantillons, stéréo, analyseur arrêté puis actif.
+        Le calcul des FFT se fait sur le thread de fond, pendant la mesure.
+    */
+    juce::var benchAnalyser(double seconds)
+    {
+        auto *result = new juce::DynamicObject();
+        double realtimeLoad[2] {};
+
+        std::cout << std::endl << "Analyser   ns/smp   % of realtime" << std::endl;
+
+        for (auto active : { false, true })
+        {
+            BenchCase benchCase;
+            benchCase.blockSize = 64;
+            benchCase.analyser = active;
+
+            auto caseResult = runComponentCase(benchCase, seconds);
+            auto nsPerSample = (double) caseResult.getProperty("nsPerSample", 0.0);
+            realtimeLoad[active ? 1 : 0] = getRealtimePercent(caseResult, benchCase);
+
+            std::cout << juce::String(active ? "on" : "off").paddedLeft(' ', 7)
+                      << juce::String(nsPerSample, 2).paddedLeft(' ', 9)
+                      << juce::String(realtimeLoad[active ? 1 : 0], 3).paddedLeft(' ', 16) << std::endl;
+
+            result->setProperty(active ? "active" : "inactive", caseResult);
+        }
+
+        auto overhead = realtimeLoad[1] - realtimeLoad[0];
+        std::cout << "overhead" << juce::String(overhead, 3).paddedLeft(' ', 24) << " % of realtime" << std::endl;
+
+        result->setProperty("overheadRealtimePercent", overhead);
+        return result;
+    }
+
+    /*  Test de charge OSC : un émetteur UDP local envoie 10 000 messages/s pendant qu'un thread
+        cadencé comme un thread audio (blocs de 256 échantillons à 48 kHz) appelle processBlock,
+        et que le thread de messages recopie les valeurs reçues dans l'APVTS. Le thread audio ne
+        doit jamais attendre : le test réussit ("passed") si aucun bloc ne dépasse la période du
+        bloc et si aucun message n'est perdu.
+    */
+    juce::var benchOscFlood(double seconds)
+    {
+        constexpr int blockSize = 256;
+        constexpr double sampleRate = 48000.0;
+        constexpr int messagesPerSecond = 10000;
+        constexpr int messagesPerMillisecond = messagesPerSecond / 1000;
+
+        AudioPluginAudioProcessor processor;
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        auto port = 20000 + juce::Random::getSystemRandom().nextInt(20000);
+        processor.getValueTreeState().state.setProperty(EqOscServer::portProperty, port, nullptr);
+        juce::MessageManager::getInstance()->runDispatchLoopUntil(100);
+
+        auto *result = new juce::DynamicObject();
+        result->setProperty("port", port);
+
+        if (! processor.getOscServer().isConnected())
+        {
+            result->setProperty("error", "could not listen on the UDP port");
+            result->setProperty("passed", false);
+            return result;
+        }
+
+        std::atomic<bool> running { true };
+        juce::int64 numSent = 0;
+
+        std::thread sender([&]
+        {
+            juce::OSCSender oscSender;
+
+            if (! oscSender.connect("127.0.0.1", port))
+                return;
+
+            const juce::OSCAddressPattern freq("/eq/1/freq"), gain("/eq/2/gain"), q("/eq/1/q");
+            auto next = Clock::now();
+
+            while (running)
+            {
+                for (int i = 0; i < messagesPerMillisecond; ++i, ++numSent)
+                {
+                    auto phase = (float) (numSent % 1000) / 1000.0f;
+
+                    switch (numSent % 3)
+                    {
+                        case 0:  oscSender.send(freq, 100.0f + 9000.0f * phase); break;
+                        case 1:  oscSender.send(gain, -12.0f + 24.0f * phase); break;
+                        default: oscSender.send(q, 0.5f + 4.0f * phase); break;
+                    }
+                }
+
+                next += std::chrono::milliseconds(1);
+                std::this_thread::sleep_until(next);
+            }
+        });
+
+        // blockNanoseconds et allocations ne sont lus qu'après join() ; le thread principal ne suit que numBlocksDone
+        std::vector<double> blockNanoseconds;
+        juce::int64 allocations = 0;
+        std::atomic<int> numBlocksDone { 0 };
+        auto numBlocks = (int) (seconds * sampleRate) / blockSize;
+        blockNanoseconds.reserve((size_t) numBlocks);
+
+        std::thread audio([&]
+        {
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            juce::MidiBuffer midi;
+            juce::Random random(1);
+            auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(blockSize / sampleRate));
+            auto next = Clock::now();
+
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                for (int channel = 0; channel < 2; ++channel)
+                    for (int i = 0; i < blockSize; ++i)
+                        buffer.setSample(channel, i, 0.5f * (random.nextFloat() - 0.5f));
+
+                AllocationCounter::start();
+                auto start = Clock::now();
+
+                processor.processBlock(buffer, midi);
+
+                auto end = Clock::now();
+                allocations += AllocationCounter::stop();
+
+                blockNanoseconds.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+                numBlocksDone.store(block + 1, std::memory_order_release);
+
+                next += period;
+                std::this_thread::sleep_until(next);
+            }
+        });
+
+        // Le thread principal sert de thread de messages pendant le test
+        while (numBlocksDone.load(std::memory_order_acquire) < numBlocks)
+            juce::MessageManager::getInstance()->runDispatchLoopUntil(20);
+
+        audio.join();
+        running = false;
+        sender.join();
+        juce::MessageManager::getInstance()->runDispatchLoopUntil(100);
+
+        auto stats = summarise(blockNanoseconds, (juce::int64) numBlocks * blockSize, 2, allocations);
+        auto *object = stats.getDynamicObject();
+        auto blockPeriodNs = blockSize / sampleRate * 1.0e9;
+        auto numReceived = processor.getOscServer().getNumReceived();
+        auto numDropped = processor.getOscServer().getNumDropped();
+
+        // Réussi si des messages sont bien arrivés, qu'aucun n'a été perdu et qu'aucun bloc n'a dépassé sa période
+        auto maxWithinPeriod = (double) object->getProperty("blockMaxNs") < blockPeriodNs;
+        auto passed = numReceived > 0 && numDropped == 0 && maxWithinPeriod;
+
+        object->setProperty("blockPeriodNs", blockPeriodNs);
+        object->setProperty("messagesSent", numSent);
+        object->setProperty("messagesReceived", numReceived);
+        object->setProperty("messagesDropped", numDropped);
+        object->setProperty("blockMaxWithinPeriod", maxWithinPeriod);
+        object->setProperty("passed", passed);
+        object->setProperty("port", port);
+
+        std::cout << "OSC flood: " << numSent << " messages sent, " << numReceived << " received, "
+                  << numDropped << " dropped; block p99 "
+                  << juce::String((double) object->getProperty("blockP99Ns") / 1000.0, 1) << " us, max "
+                  << juce::String((double) object->getProperty("blockMaxNs") / 1000.0, 1) << " us (period "
+                  << juce::String(blockPeriodNs / 1000.0, 1) << " us), allocs/block "
+                  << juce::String((double) object->getProperty("allocationsPerBlock"), 2)
+                  << (passed ? "  PASS" : "  FAIL") << std::endl;
+
+        return stats;
+    }
+
+    /*  État du plugin pour une session de 1000 instances aux réglages aléatoires : taille, temps
+        d'écriture (getStateInformation) et de relecture (setStateInformation) du format binaire,
+        contre l'ancien XML (copyState, createXml, copyXmlToBinary), que setStateInformation lit
+        toujours. Chaque bloc est relu par l'instance suivante, pour que les valeurs changent.
+    */
+    juce::var benchState()
+    {
+        constexpr int numInstances = 1000;
+
+        std::vector<std::unique_ptr<AudioPluginAudioProcessor>> instances;
+        juce::Random random(42);
+
+        for (int i = 0; i < numInstances; ++i)
+        {
+            instances.push_back(std::make_unique<AudioPluginAudioProcessor>());
+
+            for (auto *parameter : instances.back()->getParameters())
+                parameter->setValueNotifyingHost(random.nextFloat());
+
+            instances.back()->getValueTreeState().state.setProperty(EqOscServer::loadHostProperty, "127.0.0.1", nullptr);
+        }
+
+        auto writeXml = [](AudioPluginAudioProcessor &processor, juce::MemoryBlock &destData)
+        {
+            auto state = processor.getValueTreeState().copyState();
+            std::unique_ptr<juce::XmlElement> xml(state.createXml());
+            juce::AudioProcessor::copyXmlToBinary(*xml, destData);
+        };
+
+        auto writeBinary = [](AudioPluginAudioProcessor &processor, juce::MemoryBlock &destData)
+        {
+            processor.getStateInformation(destData);
+        };
+
+        auto *result = new juce::DynamicObject();
+        result->setProperty("instances", numInstances);
+
+        std::cout << std::endl << "State (" << numInstances << " instances)   bytes   write ms   read ms" << std::endl;
+
+        for (auto binary : { false, true })
+        {
+            std::vector<juce::MemoryBlock> blocks((size_t) numInstances);
+            size_t totalBytes = 0;
+
+            auto start = juce::Time::getHighResolutionTicks();
+
+            for (size_t i = 0; i < instances.size(); ++i)
+                binary ? writeBinary(*instances[i], blocks[i]) : writeXml(*instances[i], blocks[i]);
+
+            auto writeTicks = juce::Time::getHighResolutionTicks() - start;
+            start = juce::Time::getHighResolutionTicks();
+
+            for (size_t i = 0; i < instances.size(); ++i)
+                instances[(i + 1) % instances.size()]->setStateInformation(blocks[i].getData(), (int) blocks[i].getSize());
+
+            auto readTicks = juce::Time::getHighResolutionTicks() - start;
+
+            for (auto &block : blocks)
+                totalBytes += block.getSize();
+
+            auto writeMs = juce::Time::highResolutionTicksToSeconds(writeTicks) * 1000.0;
+            auto readMs = juce::Time::highResolutionTicksToSeconds(readTicks) * 1000.0;
+
+            auto *object = new juce::DynamicObject();
+            object->setProperty("bytes", (juce::int64) totalBytes);
+            object->setProperty("writeMs", writeMs);
+            object->setProperty("readMs", readMs);
+            result->setProperty(binary ? "binary" : "xml", object);
+
+            std::cout << juce::String(binary ? "binary" : "xml").paddedLeft(' ', 26)
+                      << juce::String((juce::int64) totalBytes).paddedLeft(' ', 8)
+                      << juce::String(writeMs, 2).paddedLeft(' ', 11)
+                      << juce::String(readMs, 2).paddedLeft(' ', 10) << std::endl;
+        }
+
+        return result;
+    }
+
+    //==============================================================================
+    juce::var systemInfo(const BenchSettings &settings)
+    {
+        auto *info = new juce::DynamicObject();
+        info->setProperty("date", juce::Time::getCurrentTime().toISO8601(true));
+        info->setProperty("os", juce::SystemStats::getOperatingSystemName());
+        info->setProperty("cpu", juce::SystemStats::getCpuModel());
+        info->setProperty("cpuVendor", juce::SystemStats::getCpuVendor());
+        info->setProperty("cpuMHz", juce::SystemStats::getCpuSpeedInMegahertz());
+        info->setProperty("cores", juce::SystemStats::getNumPhysicalCpus());
+        info->setProperty("juce", juce::SystemStats::getJUCEVersion());
+        info->setProperty("floatLanes", (int) LaneInterleaver<float>::numLanes);
+        info->setProperty("doubleLanes", (int) LaneInterleaver<double>::numLanes);
+        info->setProperty("doublePrecisionState", SDPEQ_DOUBLE_PRECISION_STATE != 0);
+        info->setProperty("realtimeGuard", SDPEQ_REALTIME_GUARD != 0);
+        info->setProperty("loadMonitor", SDPEQ_LOAD_MONITOR != 0);
+       #if JUCE_DEBUG
+        info->setProperty("build", "Debug");
+       #elif defined(NDEBUG)
+        info->setProperty("build", "Release");
+       #else
+        info->setProperty("build", "Unspecified");
+       #endif
+        info->setProperty("secondsPerCase", settings.secondsPerCase);
+        return info;
+    }
+
+    void runBenchmarks(const BenchSettings &settings)
+    {
+        const std::vector<int> blockSizes = settings.quick ? std::vector<int> { 16, 64, 512, 4096 }
+                                                           : std::vector<int> { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+        const std::vector<double> sampleRates = settings.quick ? std::vector<double> { 48000.0, 192000.0 }
+                                                               : std::vector<double> { 44100.0, 48000.0, 96000.0, 192000.0 };
+        const std::vector<int> channelCounts { 1, 2 };
+        const std::vector<Automation> automations { Automation::none, Automation::stepped, Automation::sweep };
+
+        juce::Array<juce::var> matrix;
+
+        for (auto doublePrecision : { false, true })
+            for (auto sampleRate : sampleRates)
+                for (auto numChannels : channelCounts)
+                    for (auto blockSize : blockSizes)
+                        for (auto automation : automations)
+                        {
+                            BenchCase benchCase;
+                            benchCase.blockSize = blockSize;
+                            benchCase.sampleRate = sampleRate;
+                            benchCase.numChannels = numChannels;
+                            benchCase.automation = automation;
+                            benchCase.doublePrecision = doublePrecision;
+                            matrix.add(runCase(benchCase, settings.secondsPerCase));
+                        }
+
+        // Coût du lissage et des structures, à réglage fixe (512 échantillons, 48 kHz, stéréo, balayage continu)
+        juce::Array<juce::var> smoothing, topology;
+
+        for (int choice = 0; choice < EqParameters::getSmoothingChoices().size(); ++choice)
+        {
+            BenchCase benchCase;
+            benchCase.automation = Automation::sweep;
+            benchCase.smoothing = choice;
+            smoothing.add(runCase(benchCase, settings.secondsPerCase));
+        }
+
+        for (int choice = 0; choice < EqParameters::getTopologyChoices().size(); ++choice)
+            for (auto automation : automations)
+            {
+                BenchCase benchCase;
+                benchCase.automation = automation;
+                benchCase.topology = choice;
+                topology.add(runCase(benchCase, settings.secondsPerCase));
+            }
+
+        auto *components = new juce::DynamicObject();
+        components->setProperty("parameterAccess", benchParameterAccess(settings.secondsPerCase));
+        components->setProperty("cascade", benchCascade(settings.secondsPerCase));
+        components->setProperty("scalarBaseline", benchScalarBaseline(settings.secondsPerCase));
+        components->setProperty("bellDesign", benchBellDesign());
+        components->setProperty("smoothing", smoothing);
+        components->setProperty("topology", topology);
+        components->setProperty("linearPhase", benchLinearPhase(settings.secondsPerCase));
+        components->setProperty("oversampling", benchOversampling(settings.secondsPerCase));
+        components->setProperty("routing", benchRouting(settings.secondsPerCase));
+        components->setProperty("channels", benchChannels(settings.secondsPerCase));
+        components->setProperty("idle", benchIdle(settings.secondsPerCase));
+        components->setProperty("loadMonitor", benchLoadMonitor());
+        components->setProperty("dynamics", benchDynamics(settings.secondsPerCase));
+        components->setProperty("analyser", benchAnalyser(juce::jmax(2.0, settings.secondsPerCase * 2.0)));
+        components->setProperty("oscFlood", benchOscFlood(juce::jmax(2.0, settings.secondsPerCase * 4.0)));
+        components->setProperty("state", benchState());
+
+        auto *root = new juce::DynamicObject();
+        root->setProperty("system", systemInfo(settings));
+        root->setProperty("processBlock", matrix);
+        root->setProperty("components", components);
+
+       #if SDPEQ_REALTIME_GUARD
+        // Mode report seulement : en mode normal, la première violation a déjà arrêté le banc
+        root->setProperty("realtimeGuardViolations", EqRealtimeGuard::getNumViolations());
+        std::cout << "Realtime guard: " << EqRealtimeGuard::getNumViolations() << " violations in processBlock" << std::endl;
+       #endif
+
+        if (! settings.output.replaceWithText(juce::JSON::toString(juce::var(root))))
+            juce::ConsoleApplication::fail("Could not write " + settings.output.getFullPathName());
+
+        std::cout << "Results written to " << settings.output.getFullPathName() << std::endl;
+    }
+}
+
+//==============================================================================
+int main(int argc, char *argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ConsoleApplication app;
+    app.addHelpCommand("--help|-h", "Usage:", true);
+
+    app.addDefaultCommand({ "",
+                            "[--output=<file.json>] [--seconds=<audio seconds per case>] [--quick]",
+                            "Benchmarks the EQ processBlock and writes the results as JSON",
+                            "Runs every combination of block size (16-4096), sample rate (44.1-192 kHz), channel count, precision and\n"
+                            "automation pattern (static, stepped, continuous sweep), then a few component benchmarks.\n"
+                            "--quick runs a reduced matrix. Build in Release for meaningful numbers.",
+                            [](const juce::ArgumentList &args)
+                            {
+                                BenchSettings settings;
+                                settings.quick = args.containsOption("--quick");
+                                settings.secondsPerCase = settings.quick ? 0.25 : 1.0;
+
+                                if (args.containsOption("--seconds"))
+                                    settings.secondsPerCase = args.getValueForOption("--seconds").getDoubleValue();
+
+                                settings.output = args.containsOption("--output")
+                                                    ? args.getFileForOption("--output")
+                                                    : juce::File::getCurrentWorkingDirectory().getChildFile("bench_results.json");
+
+                                if (settings.secondsPerCase <= 0.0)
+                                    juce::ConsoleApplication::fail("--seconds must be positive");
+
+                                runBenchmarks(settings);
+                            } });
+
+    return app.findAndRunCommand(argc, argv);
+}
@@ -0,0 +1,159 @@
+#include "AllocationCounter.h"
+
+// Avec SDPEQ_REALTIME_GUARD, malloc et ses variantes sont déjà remplacés par EqRealtimeGuard.cpp
+#if defined(__linux__) && defined(__GLIBC__) && ! SDPEQ_REALTIME_GUARD
+ #define SDPEQ_COUNT_MALLOC 1
+#else
+ #define SDPEQ_COUNT_MALLOC 0
+#endif
+
+#if SDPEQ_COUNT_MALLOC
+ #include <cerrno>
+
+// Allocateur de la glibc, appelé directement (comme dans EqRealtimeGuard.cpp)
+extern "C"
+{
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t count, size_t size);
+    void *__libc_realloc(void *pointer, size_t size);
+    void *__libc_memalign(size_t alignment, size_t size);
+}
+#endif
+
+namespace
+{
+    // initial-exec : lisibles depuis malloc sans passer par __tls_get_addr, qui peut allouer
+    thread_local bool countingAllocations __attribute__((tls_model("initial-exec"))) = false;
+    thread_local juce::int64 numAllocations __attribute__((tls_model("initial-exec"))) = 0;
+
+    void count() noexcept
+    {
+        if (countingAllocations)
+            ++numAllocations;
+    }
+
+    // Quand malloc est compté, operator new le laisse compter : une allocation n'est comptée qu'une fois
+    void countNew() noexcept
+    {
+       #if ! SDPEQ_COUNT_MALLOC
+        count();
+       #endif
+    }
+
+    void *allocate(std::size_t size)
+    {
+        countNew();
+
+        if (auto *p = std::malloc(size == 0 ? 1 : size))
+            return p;
+
+        throw std::bad_alloc();
+    }
+
+    void *allocateAligned(std::size_t size, std::align_val_t alignment)
+    {
+        countNew();
+
+        auto align = juce::jmax(sizeof(void *), static_cast<std::size_t>(alignment));
+        void *p = nullptr;
+
+       #if JUCE_WINDOWS
+        p = _aligned_malloc(size == 0 ? 1 : size, align);
+       #else
+        if (posix_memalign(&p, align, size == 0 ? 1 : size) != 0)
+            p = nullptr;
+       #endif
+
+        if (p == nullptr)
+            throw std::bad_alloc();
+
+        return p;
+    }
+
+    void freeAligned(void *p) noexcept
+    {
+       #if JUCE_WINDOWS
+        _aligned_free(p);
+       #else
+        std::free(p);
+       #endif
+    }
+}
+
+void *operator new(std::size_t size) { return allocate(size); }
+void *operator new[](std::size_t size) { return allocate(size); }
+void *operator new(std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void *operator new[](std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { freeAligned(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { freeAligned(p); }
+
+//==============================================================================
+#if SDPEQ_COUNT_MALLOC
+extern "C" void *malloc(size_t size) __THROW
+{
+    count();
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t numElements, size_t size) __THROW
+{
+    count();
+    return __libc_calloc(numElements, size);
+}
+
+extern "C" void *realloc(void *pointer, size_t size) __THROW
+{
+    count();
+    return __libc_realloc(pointer, size);
+}
+
+extern "C" void *memalign(size_t alignment, size_t size) __THROW
+{
+    count();
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" void *aligned_alloc(size_t alignment, size_t size) __THROW
+{
+    count();
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void **result, size_t alignment, size_t size) __THROW
+{
+    count();
+
+    if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0)
+        return EINVAL;
+
+    *result = __libc_memalign(alignment, size);
+    return *result != nullptr || size == 0 ? 0 : ENOMEM;
+}
+#endif
+
+//==============================================================================
+namespace AllocationCounter
+{
+    void start() noexcept
+    {
+        numAllocations = 0;
+        countingAllocations = true;
+    }
+
+    juce::int64 stop() noexcept
+    {
+        countingAllocations = false;
+        return numAllocations;
+    }
+
+    bool isCountingMalloc() noexcept
+    {
+        return SDPEQ_COUNT_MALLOC != 0;
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+//==============================================================================
+/**
+    Compteur d'allocations du banc de mesure et des tests : toutes les formes de operator new
+    sont remplacées dans l'exécutable qui compile AllocationCounter.cpp, et sous Linux / glibc
+    malloc, calloc, realloc et les allocations alignées aussi (juce::HeapBlock, donc
+    AudioBuffer et juce::Array, alloue par malloc). Le compte est propre à chaque thread,
+    pour ne pas mesurer les threads réseau, de messages ou de conception des filtres
+    pendant un processBlock.
+
+    Avec SDPEQ_REALTIME_GUARD, malloc appartient à la garde, qui signale elle-même toute
+    allocation de processBlock : seul operator new est alors compté ici.
+*/
+namespace AllocationCounter
+{
+    // Remet le compte du thread courant à zéro et commence à compter
+    void start() noexcept;
+
+    // Arrête de compter et renvoie le nombre d'allocations depuis start()
+    juce::int64 stop() noexcept;
+
+    // true si malloc et ses variantes sont comptés, pas seulement operator new
+    bool isCountingMalloc() noexcept;
+}
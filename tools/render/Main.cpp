@@ -0,0 +1,267 @@
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "PluginProcessor.h"
+
+//==============================================================================
+/*  Rendu hors ligne : passe un fichier audio dans AudioPluginAudioProcessor, sans hôte,
+    avec exactement le DSP du plugin.
+
+    La lecture et l'écriture tournent chacune sur leur propre thread (BufferingAudioReader
+    et AudioFormatWriter::ThreadedWriter) avec plusieurs blocs d'avance : pendant que le
+    processeur traite un bloc, le suivant est déjà lu et le précédent est en cours
+    d'écriture. Le débit est donc limité par le DSP, pas par le disque ou le décodeur.
+*/
+namespace
+{
+    constexpr int defaultBlockSize = 512;
+
+    // Avance de lecture et tampon d'écriture, en blocs (au moins une seconde d'audio)
+    constexpr int numBufferedBlocks = 16;
+
+    struct RenderSettings
+    {
+        juce::File input, output, state;
+        juce::StringArray assignments;
+        int blockSize = defaultBlockSize;
+        int bitsPerSample = 0; // 0 : même résolution que le fichier d'entrée
+        bool doublePrecision = false;
+    };
+
+    RenderSettings parseSettings(const juce::ArgumentList &args)
+    {
+        args.failIfOptionIsMissing("--input");
+        args.failIfOptionIsMissing("--output");
+
+        RenderSettings settings;
+        settings.input = args.getExistingFileForOption("--input");
+        settings.output = args.getFileForOption("--output");
+
+        if (args.containsOption("--state"))
+            settings.state = args.getExistingFileForOption("--state");
+
+        if (args.containsOption("--block-size"))
+            settings.blockSize = args.getValueForOption("--block-size").getIntValue();
+
+        if (args.containsOption("--bits"))
+            settings.bitsPerSample = args.getValueForOption("--bits").getIntValue();
+
+        settings.doublePrecision = args.containsOption("--double");
+
+        // --set peut être répété : une affectation ID=valeur par option
+        for (int i = 0; i < args.size(); ++i)
+            if (args[i].isLongOption("set"))
+                settings.assignments.add(args[i].getLongOptionValue());
+
+        if (settings.blockSize <= 0)
+            juce::ConsoleApplication::fail("--block-size must be a positive number of samples");
+
+        return settings;
+    }
+
+    // "EQ1_GAIN=6" : la valeur est dans l'unité du paramètre (Hz, dB, index de choix, 0 / 1)
+    void applyAssignment(juce::AudioProcessorValueTreeState &parameters, const juce::String &assignment)
+    {
+        auto id = assignment.upToFirstOccurrenceOf("=", false, false).trim();
+        auto value = assignment.fromFirstOccurrenceOf("=", false, false).trim();
+        auto *parameter = parameters.getParameter(id);
+
+        if (parameter == nullptr || value.isEmpty())
+            juce::ConsoleApplication::fail("Invalid parameter assignment: " + assignment);
+
+        parameter->setValueNotifyingHost(parameters.getParameterRange(id).convertTo0to1(value.getFloatValue()));
+    }
+
+    void loadState(AudioPluginAudioProcessor &processor, const juce::File &file)
+    {
+        juce::MemoryBlock data;
+
+        if (! file.loadFileAsData(data))
+            juce::ConsoleApplication::fail("Could not read state file: " + file.getFullPathName());
+
+        processor.setStateInformation(data.getData(), (int) data.getSize());
+    }
+
+    // Résolution demandée si le format la supporte, sinon la plus proche au-dessus (ou la plus haute)
+    int chooseBitDepth(juce::AudioFormat &format, int requested)
+    {
+        auto depths = format.getPossibleBitDepths();
+
+        if (depths.isEmpty() || depths.contains(requested))
+            return requested;
+
+        for (auto depth : depths)
+            if (depth > requested)
+                return depth;
+
+        return depths.getLast();
+    }
+
+    // Les latencySamples premiers échantillons de sortie ne sont pas écrits : le fichier reste aligné sur l'entrée
+    template <typename SampleType>
+    double renderBlocks(AudioPluginAudioProcessor &processor, juce::AudioFormatReader &reader,
+                        juce::AudioFormatWriter::ThreadedWriter &writer, int numChannels, int blockSize,
+                        juce::int64 totalSamples, int latencySamples)
+    {
+        juce::AudioBuffer<float> io(numChannels, blockSize);
+        juce::AudioBuffer<SampleType> work(numChannels, blockSize);
+        std::vector<const float *> output((size_t) numChannels);
+        juce::MidiBuffer midi;
+        juce::int64 dspTicks = 0;
+
+        for (juce::int64 position = 0; position < totalSamples; position += blockSize)
+        {
+            auto numSamples = (int) juce::jmin((juce::int64) blockSize, totalSamples - position);
+
+            // Au-delà de la fin du fichier (traîne du processeur), le lecteur renvoie du silence
+            reader.read(&io, 0, numSamples, position, true, true);
+
+            auto start = juce::Time::getHighResolutionTicks();
+
+            if constexpr (std::is_same_v<SampleType, float>)
+            {
+                juce::AudioBuffer<float> block(io.getArrayOfWritePointers(), numChannels, numSamples);
+                processor.processBlock(block, midi);
+            }
+            else
+            {
+                for (int channel = 0; channel < numChannels; ++channel)
+                    for (int i = 0; i < numSamples; ++i)
+                        work.setSample(channel, i, (SampleType) io.getSample(channel, i));
+
+                juce::AudioBuffer<SampleType> block(work.getArrayOfWritePointers(), numChannels, numSamples);
+                processor.processBlock(block, midi);
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                    for (int i = 0; i < numSamples; ++i)
+                        io.setSample(channel, i, (float) work.getSample(channel, i));
+            }
+
+            dspTicks += juce::Time::getHighResolutionTicks() - start;
+
+            auto skip = (int) juce::jlimit((juce::int64) 0, (juce::int64) numSamples, latencySamples - position);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                output[(size_t) channel] = io.getReadPointer(channel, skip);
+
+            // Le tampon d'écriture est plein : le disque est en retard, on attend qu'il se vide
+            while (skip < numSamples && ! writer.write(output.data(), numSamples - skip))
+                juce::Thread::sleep(1);
+        }
+
+        return juce::Time::highResolutionTicksToSeconds(dspTicks);
+    }
+
+    void render(const RenderSettings &settings)
+    {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        std::unique_ptr<juce::AudioFormatReader> source(formatManager.createReaderFor(settings.input));
+
+        if (source == nullptr)
+            juce::ConsoleApplication::fail("Unsupported or unreadable input file: " + settings.input.getFullPathName());
+
+        auto *outputFormat = formatManager.findFormatForFileExtension(settings.output.getFileExtension());
+
+        if (outputFormat == nullptr)
+            juce::ConsoleApplication::fail("Unsupported output format: " + settings.output.getFileName());
+
+        auto sampleRate = source->sampleRate;
+        auto numChannels = (int) source->numChannels;
+        auto inputLength = source->lengthInSamples;
+        auto bufferedSamples = juce::jmax(settings.blockSize * numBufferedBlocks, (int) sampleRate);
+
+        //==============================================================================
+        AudioPluginAudioProcessor processor;
+        auto channelSet = juce::AudioChannelSet::canonicalChannelSet(numChannels);
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(channelSet);
+        layout.inputBuses.add(juce::AudioChannelSet::disabled()); // Pas de sidechain hors ligne
+        layout.outputBuses.add(channelSet);
+
+        if (! processor.setBusesLayout(layout))
+            juce::ConsoleApplication::fail("Unsupported channel count: " + juce::String(numChannels));
+
+        if (settings.state.existsAsFile())
+            loadState(processor, settings.state);
+
+        for (auto &assignment : settings.assignments)
+            applyAssignment(processor.getValueTreeState(), assignment);
+
+        processor.setNonRealtime(true);
+        processor.setProcessingPrecision(settings.doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                                  : juce::AudioProcessor::singlePrecision);
+        processor.setRateAndBufferSizeDetails(sampleRate, settings.blockSize);
+        processor.prepareToPlay(sampleRate, settings.blockSize);
+
+        // En phase linéaire, la sortie est en retard de la latence : on traite d'autant plus d'échantillons
+        auto latencySamples = processor.getLatencySamples();
+        auto tailSamples = (juce::int64) std::ceil(processor.getTailLengthSeconds() * sampleRate);
+        auto totalSamples = inputLength + tailSamples + latencySamples;
+
+        //==============================================================================
+        // Les threads sont créés avant le lecteur et l'écrivain, et détruits après eux
+        juce::TimeSliceThread readThread("Render reader"), writeThread("Render writer");
+        readThread.startThread();
+        writeThread.startThread();
+
+        auto bitsPerSample = settings.bitsPerSample > 0 ? settings.bitsPerSample
+                                                        : (source->usesFloatingPointData ? 32 : (int) source->bitsPerSample);
+
+        juce::BufferingAudioReader reader(source.release(), readThread, bufferedSamples);
+        reader.setReadTimeout(-1);
+
+        settings.output.deleteFile();
+        auto stream = std::make_unique<juce::FileOutputStream>(settings.output);
+
+        if (! stream->openedOk())
+            juce::ConsoleApplication::fail("Could not open output file: " + settings.output.getFullPathName());
+
+        std::unique_ptr<juce::AudioFormatWriter> fileWriter(outputFormat->createWriterFor(stream.get(), sampleRate, (unsigned int) numChannels,
+                                                                                          chooseBitDepth(*outputFormat, bitsPerSample), {}, 0));
+
+        if (fileWriter == nullptr)
+            juce::ConsoleApplication::fail("Could not create a " + outputFormat->getFormatName() + " writer for this file");
+
+        stream.release(); // appartient maintenant à fileWriter
+
+        auto writer = std::make_unique<juce::AudioFormatWriter::ThreadedWriter>(fileWriter.release(), writeThread, bufferedSamples);
+
+        auto start = juce::Time::getHighResolutionTicks();
+        auto dspSeconds = settings.doublePrecision
+                            ? renderBlocks<double>(processor, reader, *writer, numChannels, settings.blockSize, totalSamples, latencySamples)
+                            : renderBlocks<float>(processor, reader, *writer, numChannels, settings.blockSize, totalSamples, latencySamples);
+
+        // Vide le tampon d'écriture et ferme le fichier
+        writer.reset();
+
+        auto totalSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        auto audioSeconds = (double) totalSamples / sampleRate;
+
+        processor.releaseResources();
+
+        std::cout << "Rendered " << settings.output.getFullPathName() << ": "
+                  << totalSamples - latencySamples << " samples x " << numChannels << " channels ("
+                  << juce::String(audioSeconds, 2) << " s of audio) in " << juce::String(totalSeconds, 3) << " s, DSP "
+                  << juce::String(dspSeconds, 3) << " s (" << juce::String(audioSeconds / juce::jmax(dspSeconds, 1.0e-9), 1)
+                  << "x realtime)" << std::endl;
+    }
+}
+
+//==============================================================================
+int main(int argc, char *argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ConsoleApplication app;
+    app.addHelpCommand("--help|-h", "Usage:", true);
+
+    app.addDefaultCommand({ "",
+                            "--input=<file> --output=<file> [--state=<file>] [--set=<ID>=<value> ...] [--block-size=<n>] [--bits=<n>] [--double]",
+                            "Renders an audio file through the EQ",
+                            "Reads any format known to AudioFormatManager (WAV, AIFF, FLAC, Ogg), applies the parameters of a state file\n"
+                            "saved by getStateInformation() and then the --set assignments (in parameter units, e.g. --set=EQ1_GAIN=6),\n"
+                            "and writes the result in the format given by the output file extension. --double runs the double-precision path.",
+                            [](const juce::ArgumentList &args) { render(parseSettings(args)); } });
+
+    return app.findAndRunCommand(argc, argv);
+}